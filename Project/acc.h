@@ -25,6 +25,18 @@
 #define ACCL_ADDR           0x1D
 
 #define ACCL_INT            0x2E
+#define ACCL_INT_MAP        0x2F
+#define ACCL_INT_SOURCE     0x30
+// Parameters for ACCL_INT, ACCL_INT_MAP (set = INT2) and ACCL_INT_SOURCE:
+#define ACCL_INT_DATA_READY 0x80
+#define ACCL_INT_SINGLE_TAP 0x40
+#define ACCL_INT_DOUBLE_TAP 0x20
+#define ACCL_INT_ACTIVITY   0x10
+#define ACCL_INT_INACTIVITY 0x08
+#define ACCL_INT_FREE_FALL  0x04
+#define ACCL_INT_WATERMARK  0x02
+#define ACCL_INT_OVERRUN    0x01
+
 #define ACCL_OFFSET_X       0x1E
 #define ACCL_OFFSET_Y       0x1F
 #define ACCL_OFFSET_Z       0x20
@@ -33,7 +45,28 @@
 
 #define ACCL_PWR_CTL        0x2D
 // Parameters for ACCL_PWR_CTL:
+#define ACCL_LINK           0x20    // Activity and inactivity alternate
+#define ACCL_AUTO_SLEEP     0x10    // Sleep on inactivity (needs LINK)
 #define ACCL_MEASURE        0x08
+#define ACCL_SLEEP          0x04
+#define ACCL_WAKEUP_8HZ     0x00    // Sampling rate while asleep
+#define ACCL_WAKEUP_4HZ     0x01
+#define ACCL_WAKEUP_2HZ     0x02
+#define ACCL_WAKEUP_1HZ     0x03
+
+#define ACCL_THRESH_ACT     0x24    // 62.5 mg/LSB
+#define ACCL_THRESH_INACT   0x25    // 62.5 mg/LSB
+#define ACCL_TIME_INACT     0x26    // 1 s/LSB
+#define ACCL_ACT_INACT_CTL  0x27
+// Parameters for ACCL_ACT_INACT_CTL:
+#define ACCL_ACT_AC         0x80    // AC coupled activity
+#define ACCL_ACT_X          0x40
+#define ACCL_ACT_Y          0x20
+#define ACCL_ACT_Z          0x10
+#define ACCL_INACT_AC       0x08    // AC coupled inactivity
+#define ACCL_INACT_X        0x04
+#define ACCL_INACT_Y        0x02
+#define ACCL_INACT_Z        0x01
 
 #define ACCL_DATA_FORMAT    0x31
 // Parameters for ACCL_DATA_FORMAT:
@@ -43,9 +76,26 @@
 #define ACCL_RANGE_16G      0x03
 #define ACCL_FULL_RES       0x08
 #define ACCL_JUSTIFY        0x04
+#define ACCL_INT_INVERT     0x20
+
+#define ACCL_FIFO_CTL       0x38
+// Parameters for ACCL_FIFO_CTL:
+#define ACCL_FIFO_BYPASS    0x00
+#define ACCL_FIFO_FIFO      0x40
+#define ACCL_FIFO_STREAM    0x80
+#define ACCL_FIFO_TRIGGER   0xC0
+#define ACCL_FIFO_TRIG_INT2 0x20
+#define ACCL_FIFO_SAMPLES   0x1F    // Mask for the watermark level
+
+#define ACCL_FIFO_STATUS    0x39
+// Fields of ACCL_FIFO_STATUS:
+#define ACCL_FIFO_TRIG      0x80
+#define ACCL_FIFO_ENTRIES   0x3F    // Mask for the number of samples held
+#define ACCL_FIFO_DEPTH     32
 
 #define ACCL_BW_RATE        0x2C
 // Parameters for ACCL_BW_RATE:
+#define ACCL_LOW_POWER      0x10    // Reduced power, slightly higher noise
 #define ACCL_RATE_3200HZ    0x0F
 #define ACCL_RATE_1600HZ    0x0E
 #define ACCL_RATE_800HZ     0x0D
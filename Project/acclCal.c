@@ -0,0 +1,222 @@
+/**********************************************************
+ *
+ * acclCal.c
+ *
+ * Zero-g calibration of the ADXL345, see acclCal.h.
+ *
+ * The EEPROM record is two words: ACCL_CAL_MAGIC, then the
+ * X, Y and Z offsets in bytes 0 to 2 and their CRC-8 in
+ * byte 3.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "driverlib/sysctl.h"
+#include "driverlib/eeprom.h"
+#include "acc.h"
+#include "i2cQueue.h"
+#include "crc8.h"
+#include "acclCal.h"
+
+#define ACCL_CAL_MAGIC      0x4C414341  // "ACAL"
+#define ACCL_CAL_SHIFT      7           // log2(ACCL_CAL_SAMPLES)
+
+typedef char acclCalSamplesCheck[(1 << ACCL_CAL_SHIFT) == ACCL_CAL_SAMPLES
+                                 ? 1 : -1];
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static int8_t offsets[3];
+static bool busy;
+static bool storing;            // Window done, offsets not yet written
+static uint16_t count;
+static uint16_t waited;         // Samples since acclCalStart()
+static int32_t sums[3];
+static int16_t mins[3];
+static int16_t maxs[3];
+static vector3_t gravity;
+
+/*********************************************************
+ * initAcclCal
+ *********************************************************/
+bool
+initAcclCal (void)
+{
+    uint32_t record[2];
+    uint8_t bytes[3];
+    uint8_t axis;
+
+    SysCtlPeripheralEnable (SYSCTL_PERIPH_EEPROM0);
+    offsets[0] = offsets[1] = offsets[2] = 0;
+    busy = false;
+    storing = false;
+    if (EEPROMInit () != EEPROM_INIT_OK)
+        return false;
+
+    EEPROMRead (record, ACCL_CAL_EEPROM, sizeof (record));
+    for (axis = 0; axis < 3; axis++)
+        bytes[axis] = (record[1] >> (8 * axis)) & 0xFF;
+    if (record[0] != ACCL_CAL_MAGIC || crc8 (bytes, 3) != record[1] >> 24)
+        return false;
+
+    for (axis = 0; axis < 3; axis++)
+        offsets[axis] = (int8_t) bytes[axis];
+    return true;
+}
+
+bool
+acclCalWriteOffsets (void)
+{
+    return writeI2CReg (ACCL_ADDR, ACCL_OFFSET_X, (uint8_t) offsets[0])
+           && writeI2CReg (ACCL_ADDR, ACCL_OFFSET_Y, (uint8_t) offsets[1])
+           && writeI2CReg (ACCL_ADDR, ACCL_OFFSET_Z, (uint8_t) offsets[2]);
+}
+
+void
+acclCalStart (void)
+{
+    busy = true;
+    count = 0;
+    waited = 0;
+}
+
+bool
+acclCalBusy (void)
+{
+    return busy;
+}
+
+vector3_t
+acclCalGravity (void)
+{
+    return gravity;
+}
+
+/*********************************************************
+ * storeOffsets: writes the registers and, once all three
+ * writes are queued, the EEPROM record. Returns false if
+ * they were not, so the EEPROM never holds offsets the
+ * ADXL345 has not been sent. A write that was queued before
+ * a refused one is simply sent again on the next try.
+ *********************************************************/
+static bool
+storeOffsets (void)
+{
+    uint32_t record[2];
+    uint8_t bytes[3];
+    uint8_t axis;
+
+    if (!acclCalWriteOffsets ())
+        return false;
+
+    for (axis = 0; axis < 3; axis++)
+        bytes[axis] = (uint8_t) offsets[axis];
+    record[0] = ACCL_CAL_MAGIC;
+    record[1] = bytes[0] | (uint32_t) bytes[1] << 8 | (uint32_t) bytes[2] << 16
+                | (uint32_t) crc8 (bytes, 3) << 24;
+    EEPROMProgram (record, ACCL_CAL_EEPROM, sizeof (record));
+    return true;
+}
+
+static uint8_t
+finishCal (void)
+{
+    if (!storeOffsets ())
+    {
+        storing = true;         // Tried again with the next sample
+        return ACCL_CAL_WAITING;
+    }
+    storing = false;
+    busy = false;
+    return ACCL_CAL_DONE;
+}
+
+/*********************************************************
+ * acclCalUpdate: once the window is full, each axis' error
+ * is removed from its offset, rounded to whole offset LSBs.
+ *********************************************************/
+uint8_t
+acclCalUpdate (vector3_t sample)
+{
+    int16_t values[3];
+    int16_t means[3];
+    int16_t target;
+    int16_t step;
+    int32_t ofs;
+    uint8_t axis;
+    uint8_t down = 0;
+
+    if (!busy)
+        return ACCL_CAL_WAITING;
+    if (storing)
+        return finishCal ();
+    if (++waited > ACCL_CAL_TIMEOUT)
+    {
+        busy = false;
+        return ACCL_CAL_GAVE_UP;
+    }
+
+    values[0] = sample.x;
+    values[1] = sample.y;
+    values[2] = sample.z;
+    for (axis = 0; axis < 3; axis++)
+    {
+        if (count == 0)
+        {
+            sums[axis] = 0;
+            mins[axis] = maxs[axis] = values[axis];
+        }
+        sums[axis] += values[axis];
+        if (values[axis] < mins[axis])
+            mins[axis] = values[axis];
+        if (values[axis] > maxs[axis])
+            maxs[axis] = values[axis];
+        if (maxs[axis] - mins[axis] > ACCL_CAL_STILL)
+        {
+            count = 0;          // Moved, start again
+            return ACCL_CAL_WAITING;
+        }
+    }
+    if (++count < ACCL_CAL_SAMPLES)
+        return ACCL_CAL_WAITING;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        means[axis] = (sums[axis] + ACCL_CAL_SAMPLES / 2) >> ACCL_CAL_SHIFT;
+        if (abs (means[axis]) > abs (means[down]))
+            down = axis;
+    }
+    for (axis = 0; axis < 3; axis++)
+        if (axis != down && abs (means[axis]) > ACCL_CAL_LEVEL)
+        {
+            count = 0;          // Tilted, wait for a level window
+            return ACCL_CAL_WAITING;
+        }
+    for (axis = 0; axis < 3; axis++)
+    {
+        target = 0;
+        if (axis == down)
+            target = (means[axis] < 0) ? -ACCL_CAL_ONE_G : ACCL_CAL_ONE_G;
+        step = means[axis] - target;
+        step = (step + ((step < 0) ? -ACCL_CAL_OFS_LSB / 2 : ACCL_CAL_OFS_LSB / 2))
+               / ACCL_CAL_OFS_LSB;
+        ofs = offsets[axis] - step;
+        if (ofs > INT8_MAX)
+            ofs = INT8_MAX;
+        if (ofs < INT8_MIN)
+            ofs = INT8_MIN;
+        means[axis] += (ofs - offsets[axis]) * ACCL_CAL_OFS_LSB;
+        offsets[axis] = ofs;
+    }
+    gravity.x = means[0];
+    gravity.y = means[1];
+    gravity.z = means[2];
+
+    return finishCal ();
+}
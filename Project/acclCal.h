@@ -0,0 +1,94 @@
+#ifndef ACCLCAL_H_
+#define ACCLCAL_H_
+
+/**********************************************************
+ *
+ * acclCal.h
+ *
+ * Zero-g calibration of the ADXL345. The device is held
+ * still for ACCL_CAL_SAMPLES samples. The axis with the
+ * largest mean is taken to carry gravity and should read
+ * +-ACCL_CAL_ONE_G; the others should read 0. The errors
+ * are written into the OFSX, OFSY and OFSZ registers, so
+ * the part corrects every sample itself. The offsets are
+ * stored in the MCU's EEPROM, and initAccl() writes them
+ * back at start up, so no calibration is needed after a
+ * reset.
+ *
+ * One still window cannot tell a bias from a tilt, so the
+ * device must lie level, on any face. A window is thrown
+ * away and a new one started if any axis moves more than
+ * ACCL_CAL_STILL counts, or if an axis across gravity reads
+ * more than ACCL_CAL_LEVEL counts (a tilt of about 7
+ * degrees). Samples are fed in from main() one at a time.
+ * If no window passes within ACCL_CAL_TIMEOUT samples, the
+ * calibration gives up and the offsets stay as they were,
+ * so a device that is never put down still gets on with
+ * counting steps. Nothing is stored, so an uncalibrated
+ * device tries again at the next start up.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vector3.h"
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+#define ACCL_CAL_SAMPLES    128     // Window averaged, a power of two
+#define ACCL_CAL_STILL      16      // Largest spread per axis (62.5 mg)
+#define ACCL_CAL_LEVEL      32      // Largest mean across gravity (125 mg)
+#define ACCL_CAL_ONE_G      256     // Counts per g, full resolution
+#define ACCL_CAL_OFS_LSB    4       // Counts per offset LSB (15.6 mg)
+#define ACCL_CAL_EEPROM     0x000   // EEPROM address of the record
+#define ACCL_CAL_TIMEOUT    2000    // Samples before giving up (20 s)
+
+enum acclCalResults {ACCL_CAL_WAITING = 0,  // Collecting, or not started
+                     ACCL_CAL_DONE,         // Offsets written and stored
+                     ACCL_CAL_GAVE_UP};     // No window in ACCL_CAL_TIMEOUT
+
+// *******************************************************
+// initAcclCal: Loads the stored offsets from EEPROM. Call
+// before initAccl(). Returns false if none are stored, in
+// which case the offsets are 0.
+bool
+initAcclCal (void);
+
+// *******************************************************
+// acclCalWriteOffsets: Queues the writes of the offsets to
+// the OFSX, OFSY and OFSZ registers; initAccl() calls it.
+// Returns false unless all three were queued.
+bool
+acclCalWriteOffsets (void);
+
+// *******************************************************
+// acclCalStart: Begins collecting a still window.
+void
+acclCalStart (void);
+
+// *******************************************************
+// acclCalBusy: True from acclCalStart() until calibrated.
+bool
+acclCalBusy (void);
+
+// *******************************************************
+// acclCalUpdate: Adds a sample to the window. Returns
+// ACCL_CAL_DONE once, when the new offsets have been written
+// and stored, or ACCL_CAL_GAVE_UP once, on the timeout.
+// If the I2C queue has no room for the writes, they are
+// tried again with each following sample, and nothing goes
+// to EEPROM until they are queued.
+uint8_t
+acclCalUpdate (vector3_t sample);
+
+// *******************************************************
+// acclCalGravity: The mean of the last window, corrected by
+// the new offsets. A clean reference orientation.
+vector3_t
+acclCalGravity (void);
+
+#endif /* ACCLCAL_H_ */
@@ -0,0 +1,194 @@
+/**********************************************************
+ *
+ * buttonEvents.c
+ *
+ * Button gesture classification, see buttonEvents.h.
+ *
+ * Each button has a small state machine:
+ *   IDLE    -press->    HELD
+ *   HELD    -release->  GAP (first press), or IDLE after a
+ *                       DOUBLE (second press) or once long
+ *   HELD    -time->     LONG, then REPEAT, staying HELD
+ *   GAP     -press->    HELD as the second press
+ *   GAP     -time->     SHORT, IDLE
+ * Edges are taken in order with their own time stamps, and
+ * the time-outs due before each edge are handled first.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    7th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "buttons4.h"
+#include "buttonEvents.h"
+
+enum gestureStates {GESTURE_IDLE = 0, GESTURE_HELD, GESTURE_GAP};
+
+typedef struct {
+    uint8_t state;
+    bool second;            // HELD is the second press of a double
+    bool long_sent;         // HELD has already been reported as long
+    uint32_t due_ms;        // Next time-out in HELD or GAP
+} gesture_t;
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static gesture_t gestures[NUM_BUTS];
+static buttonEvent_t events[BUT_EVENT_QUEUE_SIZE];
+static uint8_t event_head;
+static uint8_t event_tail;
+static uint32_t event_overflows;
+
+/*********************************************************
+ * initButtonEvents
+ *********************************************************/
+void
+initButtonEvents (void)
+{
+    uint8_t but;
+
+    for (but = 0; but < NUM_BUTS; but++)
+    {
+        gestures[but].state = GESTURE_IDLE;
+        gestures[but].second = false;
+        gestures[but].long_sent = false;
+    }
+    event_head = 0;
+    event_tail = 0;
+    event_overflows = 0;
+}
+
+static void
+queueEvent (uint8_t but, uint8_t type, uint32_t ms)
+{
+    if ((uint8_t) (event_head - event_tail) >= BUT_EVENT_QUEUE_SIZE)
+    {
+        event_overflows++;
+        return;
+    }
+    events[event_head % BUT_EVENT_QUEUE_SIZE].but = but;
+    events[event_head % BUT_EVENT_QUEUE_SIZE].type = type;
+    events[event_head % BUT_EVENT_QUEUE_SIZE].ms = ms;
+    event_head++;
+}
+
+// Signed difference, so the time-outs survive the millisecond count
+// wrapping.
+static bool
+reached (uint32_t now_ms, uint32_t due_ms)
+{
+    return (int32_t) (now_ms - due_ms) >= 0;
+}
+
+/*********************************************************
+ * timeOuts: Handles every time-out for one button up to
+ * now_ms.
+ *********************************************************/
+static void
+timeOuts (uint8_t but, uint32_t now_ms)
+{
+    gesture_t *g = &gestures[but];
+
+    while (g->state != GESTURE_IDLE && reached (now_ms, g->due_ms))
+    {
+        if (g->state == GESTURE_GAP)
+        {
+            queueEvent (but, BUT_SHORT, g->due_ms);
+            g->state = GESTURE_IDLE;
+        }
+        else if (!g->long_sent)
+        {
+            if (g->second)  // The first press stands on its own
+                queueEvent (but, BUT_SHORT, g->due_ms);
+            queueEvent (but, BUT_LONG, g->due_ms);
+            g->long_sent = true;
+            g->due_ms += BUT_REPEAT_MS;
+        }
+        else
+        {
+            queueEvent (but, BUT_REPEAT, g->due_ms);
+            g->due_ms += BUT_REPEAT_MS;
+        }
+    }
+}
+
+/*********************************************************
+ * edge: One debounced change at ms.
+ *********************************************************/
+static void
+edge (uint8_t but, bool pushed, uint32_t ms)
+{
+    gesture_t *g = &gestures[but];
+
+    if (pushed)
+    {
+        g->second = (g->state == GESTURE_GAP);
+        g->long_sent = false;
+        g->state = GESTURE_HELD;
+        g->due_ms = ms + BUT_LONG_MS;
+    }
+    else if (g->state == GESTURE_HELD)
+    {
+        if (g->long_sent)
+            g->state = GESTURE_IDLE;
+        else if (g->second)
+        {
+            queueEvent (but, BUT_DOUBLE, ms);
+            g->state = GESTURE_IDLE;
+        }
+        else
+        {
+            g->state = GESTURE_GAP;
+            g->due_ms = ms + BUT_DOUBLE_MS;
+        }
+    }
+}
+
+/*********************************************************
+ * updateButtonEvents
+ *********************************************************/
+void
+updateButtonEvents (uint32_t now_ms)
+{
+    uint8_t but;
+    bool pushed;
+    uint32_t ms;
+
+    while (getButtonEdge (&but, &pushed, &ms))
+    {
+        timeOuts (but, ms);
+        edge (but, pushed, ms);
+    }
+    for (but = 0; but < NUM_BUTS; but++)
+        timeOuts (but, now_ms);
+}
+
+bool
+buttonEventsBusy (void)
+{
+    uint8_t but;
+
+    for (but = 0; but < NUM_BUTS; but++)
+        if (gestures[but].state != GESTURE_IDLE)
+            return true;
+    return false;
+}
+
+bool
+getButtonEvent (buttonEvent_t *event)
+{
+    if (event_tail == event_head)
+        return false;
+    *event = events[event_tail % BUT_EVENT_QUEUE_SIZE];
+    event_tail++;
+    return true;
+}
+
+uint32_t
+buttonEventOverflows (void)
+{
+    return event_overflows;
+}
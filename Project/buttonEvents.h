@@ -0,0 +1,77 @@
+#ifndef BUTTONEVENTS_H_
+#define BUTTONEVENTS_H_
+
+/**********************************************************
+ *
+ * buttonEvents.h
+ *
+ * Button gestures on top of buttons4.c. Debounced changes
+ * from getButtonEdge() are classified per button into short,
+ * long and double presses and auto-repeat while held. The
+ * results wait in a fixed size queue for main().
+ *
+ * A short press is only reported once BUT_DOUBLE_MS has
+ * passed with no second press. A press held for
+ * BUT_LONG_MS is reported as long at that moment, then
+ * repeats every BUT_REPEAT_MS until it is released.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    7th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+#define BUT_LONG_MS         800     // Held this long is a long press
+#define BUT_REPEAT_MS       200     // Repeat period after a long press
+#define BUT_DOUBLE_MS       300     // Most time between the two presses
+#define BUT_EVENT_QUEUE_SIZE 8      // Power of 2
+
+enum butEventTypes {BUT_SHORT = 0, BUT_LONG, BUT_DOUBLE, BUT_REPEAT};
+
+// *******************************************************
+// Event structure
+typedef struct {
+    uint8_t but;            // enum butNames (buttons4.h)
+    uint8_t type;           // enum butEventTypes
+    uint32_t ms;            // schedMillis() time it was recognised
+} buttonEvent_t;
+
+// *******************************************************
+// initButtonEvents: Clears every button's gesture state and
+// the event queue.
+void
+initButtonEvents (void);
+
+// *******************************************************
+// updateButtonEvents: Takes in the debounced changes so far
+// and any gestures whose time is up at now_ms. Call when
+// buttonsChanged() is true and regularly while
+// buttonEventsBusy().
+void
+updateButtonEvents (uint32_t now_ms);
+
+// *******************************************************
+// buttonEventsBusy: True while a button is held or a second
+// press may still follow, i.e. while a gesture could still
+// be decided by time alone.
+bool
+buttonEventsBusy (void);
+
+// *******************************************************
+// getButtonEvent: Removes the oldest event. Returns false if
+// there is none.
+bool
+getButtonEvent (buttonEvent_t *event);
+
+// *******************************************************
+// buttonEventOverflows: Events dropped because the queue was
+// full.
+uint32_t
+buttonEventOverflows (void);
+
+#endif /* BUTTONEVENTS_H_ */
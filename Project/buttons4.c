@@ -12,6 +12,9 @@
 //
 // P.J. Bones UCECE
 // Last modified:  7.2.2018
+//
+// Interrupt driven debounce added by Ben Stewart and Daniel Pallesen,
+// 6th of May 2022.
 // 
 // *******************************************************
 
@@ -19,10 +22,15 @@
 #include <stdbool.h>
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
+#include "inc/hw_ints.h"
 #include "driverlib/gpio.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/interrupt.h"
 #include "driverlib/debug.h"
 #include "inc/tm4c123gh6pm.h"  // Board specific defines (for PF0)
+#include "scheduler.h"
+#include "spscQueue.h"      // SPSC_ACQUIRE, SPSC_RELEASE
 #include "buttons4.h"
 
 
@@ -33,6 +41,16 @@ static bool but_state[NUM_BUTS];	// Corresponds to the electrical state
 static uint8_t but_count[NUM_BUTS];
 static bool but_flag[NUM_BUTS];
 static bool but_normal[NUM_BUTS];   // Corresponds to the electrical state
+static volatile bool but_event;     // Set by the debounce timer
+static uint32_t but_debounce_load;  // Timer ticks in BUT_DEBOUNCE_MS
+// Debounced changes, written by the timer interrupt and read by main()
+static struct {
+    uint8_t but;
+    bool pushed;
+    uint32_t ms;
+} but_edges[BUT_EDGE_QUEUE_SIZE];
+static volatile uint8_t but_edge_head;  // Timer interrupt only
+static volatile uint8_t but_edge_tail;  // getButtonEdge() only
 
 // *******************************************************
 // initButtons: Initialise the variables associated with the set of buttons
@@ -82,6 +100,17 @@ initButtons (void)
 	}
 }
 
+// *******************************************************
+// readButtons: Reads the pins; true means HIGH, false means LOW
+static void
+readButtons (bool but_value[NUM_BUTS])
+{
+	but_value[UP] = (GPIOPinRead (UP_BUT_PORT_BASE, UP_BUT_PIN) == UP_BUT_PIN);
+	but_value[DOWN] = (GPIOPinRead (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN) == DOWN_BUT_PIN);
+    but_value[LEFT] = (GPIOPinRead (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN) == LEFT_BUT_PIN);
+    but_value[RIGHT] = (GPIOPinRead (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN) == RIGHT_BUT_PIN);
+}
+
 // *******************************************************
 // updateButtons: Function designed to be called regularly. It polls all
 // buttons once and updates variables associated with the buttons if
@@ -97,11 +126,7 @@ updateButtons (void)
 	bool but_value[NUM_BUTS];
 	int i;
 	
-	// Read the pins; true means HIGH, false means LOW
-	but_value[UP] = (GPIOPinRead (UP_BUT_PORT_BASE, UP_BUT_PIN) == UP_BUT_PIN);
-	but_value[DOWN] = (GPIOPinRead (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN) == DOWN_BUT_PIN);
-    but_value[LEFT] = (GPIOPinRead (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN) == LEFT_BUT_PIN);
-    but_value[RIGHT] = (GPIOPinRead (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN) == RIGHT_BUT_PIN);
+	readButtons (but_value);
 	// Iterate through the buttons, updating button variables as required
 	for (i = 0; i < NUM_BUTS; i++)
 	{
@@ -120,6 +145,151 @@ updateButtons (void)
 	}
 }
 
+// *******************************************************
+// initButtonInts: Edge interrupts on every button pin, debounced by a
+// one-shot timer. The timer runs from the system clock, which is the
+// 16 MHz PIOSC in deep sleep, so the quiet time stretches by a quarter
+// if the press woke the MCU. That is still well under a display period.
+void
+initButtonInts (void)
+{
+    but_debounce_load = SysCtlClockGet () / 1000 * BUT_DEBOUNCE_MS;
+    SysCtlPeripheralEnable (BUT_TIMER_PERIPH);
+    TimerConfigure (BUT_TIMER_BASE, TIMER_CFG_ONE_SHOT);
+    TimerLoadSet (BUT_TIMER_BASE, TIMER_A, but_debounce_load);
+    TimerIntClear (BUT_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    TimerIntEnable (BUT_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    IntEnable (BUT_TIMER_INT);
+
+    GPIOIntTypeSet (UP_BUT_PORT_BASE, UP_BUT_PIN, GPIO_BOTH_EDGES);
+    GPIOIntTypeSet (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN, GPIO_BOTH_EDGES);
+    GPIOIntTypeSet (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN | RIGHT_BUT_PIN,
+                    GPIO_BOTH_EDGES);   // LEFT and RIGHT share port F
+    GPIOIntClear (UP_BUT_PORT_BASE, UP_BUT_PIN);
+    GPIOIntClear (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN);
+    GPIOIntClear (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN | RIGHT_BUT_PIN);
+    GPIOIntEnable (UP_BUT_PORT_BASE, UP_BUT_PIN);
+    GPIOIntEnable (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN);
+    GPIOIntEnable (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN | RIGHT_BUT_PIN);
+    IntEnable (INT_GPIOD);
+    IntEnable (INT_GPIOE);
+    IntEnable (INT_GPIOF);
+
+    SysCtlPeripheralDeepSleepEnable (UP_BUT_PERIPH);
+    SysCtlPeripheralDeepSleepEnable (DOWN_BUT_PERIPH);
+    SysCtlPeripheralDeepSleepEnable (LEFT_BUT_PERIPH);
+    SysCtlPeripheralDeepSleepEnable (BUT_TIMER_PERIPH);
+}
+
+// *******************************************************
+// buttonEdgeInt: A bounce restarts the timer, so the pins are read
+// BUT_DEBOUNCE_MS after the last edge.
+void
+buttonEdgeInt (uint32_t portBase, uint32_t status)
+{
+    uint32_t pins = 0;
+
+    if (portBase == UP_BUT_PORT_BASE)
+        pins |= UP_BUT_PIN;
+    if (portBase == DOWN_BUT_PORT_BASE)
+        pins |= DOWN_BUT_PIN;
+    if (portBase == LEFT_BUT_PORT_BASE)
+        pins |= LEFT_BUT_PIN | RIGHT_BUT_PIN;
+    if ((status & pins) == 0)
+        return;
+    TimerDisable (BUT_TIMER_BASE, TIMER_A);
+    TimerLoadSet (BUT_TIMER_BASE, TIMER_A, but_debounce_load);
+    TimerEnable (BUT_TIMER_BASE, TIMER_A);
+}
+
+void
+GPIOPortDIntHandler (void)
+{
+    uint32_t status = GPIOIntStatus (DOWN_BUT_PORT_BASE, true);
+
+    GPIOIntClear (DOWN_BUT_PORT_BASE, status);
+    buttonEdgeInt (DOWN_BUT_PORT_BASE, status);
+}
+
+void
+GPIOPortFIntHandler (void)
+{
+    uint32_t status = GPIOIntStatus (LEFT_BUT_PORT_BASE, true);
+
+    GPIOIntClear (LEFT_BUT_PORT_BASE, status);
+    buttonEdgeInt (LEFT_BUT_PORT_BASE, status);
+}
+
+// *******************************************************
+// pushEdge: Queues one debounced change, from the timer interrupt.
+static void
+pushEdge (uint8_t but, bool pushed)
+{
+    uint8_t head = but_edge_head;
+
+    if ((uint8_t) (head - but_edge_tail) >= BUT_EDGE_QUEUE_SIZE)
+        return;
+    but_edges[head % BUT_EDGE_QUEUE_SIZE].but = but;
+    but_edges[head % BUT_EDGE_QUEUE_SIZE].pushed = pushed;
+    but_edges[head % BUT_EDGE_QUEUE_SIZE].ms = schedMillis ();
+    SPSC_RELEASE ();
+    but_edge_head = head + 1;
+}
+
+bool
+getButtonEdge (uint8_t *butName, bool *pushed, uint32_t *ms)
+{
+    uint8_t tail = but_edge_tail;
+
+    if (tail == but_edge_head)
+        return false;
+    SPSC_ACQUIRE ();
+    *butName = but_edges[tail % BUT_EDGE_QUEUE_SIZE].but;
+    *pushed = but_edges[tail % BUT_EDGE_QUEUE_SIZE].pushed;
+    *ms = but_edges[tail % BUT_EDGE_QUEUE_SIZE].ms;
+    SPSC_RELEASE ();
+    but_edge_tail = tail + 1;
+    return true;
+}
+
+// *******************************************************
+// Timer0AIntHandler: The pins have been quiet for BUT_DEBOUNCE_MS, so
+// whatever they read now is the new state.
+void
+Timer0AIntHandler (void)
+{
+    bool but_value[NUM_BUTS];
+    bool changed = false;
+    int i;
+
+    TimerIntClear (BUT_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    readButtons (but_value);
+    for (i = 0; i < NUM_BUTS; i++)
+    {
+        if (but_value[i] != but_state[i])
+        {
+            but_state[i] = but_value[i];
+            but_flag[i] = true;     // Reset by call to checkButton()
+            changed = true;
+            pushEdge (i, but_state[i] != but_normal[i]);
+        }
+    }
+    if (changed)
+    {
+        but_event = true;
+        schedNotify ();
+    }
+}
+
+bool
+buttonsChanged (void)
+{
+    if (!but_event)
+        return false;
+    but_event = false;
+    return true;
+}
+
 // *******************************************************
 // checkButton: Function returns the new button logical state if the button
 // logical state (PUSHED or RELEASED) has changed since the last call,
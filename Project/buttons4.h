@@ -11,6 +11,10 @@
 //
 // P.J. Bones UCECE
 // Last modified:  7.2.2018
+//
+// Interrupt driven debounce added by Ben Stewart and Daniel Pallesen,
+// 6th of May 2022: any edge on a button pin (re)starts a one-shot timer,
+// and the pins are read once they have been quiet for BUT_DEBOUNCE_MS.
 // 
 // *******************************************************
 
@@ -49,6 +53,13 @@ enum butStates {RELEASED = 0, PUSHED, NO_CHANGE};
 // read the pin in the opposite condition, before the state changes and
 // a flag is set.  Set NUM_BUT_POLLS according to the polling rate.
 
+// Edge interrupt debounce
+#define BUT_DEBOUNCE_MS  10     // Quiet time before the pins are read
+#define BUT_TIMER_PERIPH  SYSCTL_PERIPH_TIMER0
+#define BUT_TIMER_BASE  TIMER0_BASE
+#define BUT_TIMER_INT  INT_TIMER0A
+#define BUT_EDGE_QUEUE_SIZE  16 // Debounced changes held for getButtonEdge(), power of 2
+
 // *******************************************************
 // initButtons: Initialise the variables associated with the set of buttons
 // defined by the constants above.
@@ -63,6 +74,51 @@ initButtons (void);
 void
 updateButtons (void);
 
+// *******************************************************
+// initButtonInts: Switches from polling to edge interrupts. Call after
+// initButtons(). Every button pin interrupts on both edges, and the
+// debounce timer is set up. The buttons and the timer stay on in deep
+// sleep, so a press wakes the MCU. updateButtons() is then not needed.
+void
+initButtonInts (void);
+
+// *******************************************************
+// buttonEdgeInt: Call from a GPIO port interrupt handler with the port's
+// masked interrupt status, once it has been cleared. Restarts the
+// debounce timer if a button pin on that port changed.
+void
+buttonEdgeInt (uint32_t portBase, uint32_t status);
+
+// *******************************************************
+// buttonsChanged: Returns true (once) if the debounce timer has
+// found a button state change since the last call, so main() can skip
+// the checkButton() calls otherwise.
+bool
+buttonsChanged (void);
+
+// *******************************************************
+// getButtonEdge: Removes the oldest debounced change found by the
+// debounce timer, oldest first, unlike checkButton() which keeps only the
+// latest. pushed is the new logical state and ms the schedMillis() time
+// it was seen. Returns false if there is none. Changes that arrive while
+// the queue is full are dropped.
+bool
+getButtonEdge (uint8_t *butName, bool *pushed, uint32_t *ms);
+
+// *******************************************************
+// GPIOPortDIntHandler, GPIOPortFIntHandler, Timer0AIntHandler: Button
+// interrupt handlers, installed in the vector table in
+// tm4c123gh6pm_startup_ccs.c. Port E is shared with the accelerometer,
+// see GPIOPortEIntHandler() in readAcc.c.
+void
+GPIOPortDIntHandler (void);
+
+void
+GPIOPortFIntHandler (void);
+
+void
+Timer0AIntHandler (void);
+
 // *******************************************************
 // checkButton: Function returns the new button state if the button state
 // (PUSHED or RELEASED) has changed since the last call, otherwise returns
@@ -22,6 +22,18 @@ typedef struct {
 	uint32_t *data;		// pointer to the data
 } circBuf_t;
 
+// *******************************************************
+// CIRCBUF_DECLARE: Defines a circBuf_t called name whose
+// storage, size entries, is allocated statically and so is
+// zeroed at start-up and shows in the link map. It is ready
+// to use without initCircBuf(); do not call freeCircBuf() on
+// it. A size of 0 fails to compile. Use at file scope or as
+// a block scope static.
+#define CIRCBUF_DECLARE(name, size) \
+	typedef char name##_size_check[(size) > 0 ? 1 : -1]; \
+	static uint32_t name##_data[size]; \
+	static circBuf_t name = {(size), 0, 0, name##_data}
+
 // *******************************************************
 // initCircBuf: Initialise the circBuf instance. Reset both indices to
 // the start of the buffer.  Dynamically allocate and clear the the 
@@ -0,0 +1,28 @@
+/**********************************************************
+ *
+ * crc8.c
+ *
+ * CRC-8, polynomial 0x07, bitwise. See crc8.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    10th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include "crc8.h"
+
+uint8_t
+crc8 (const uint8_t *bytes, uint8_t len)
+{
+    uint8_t crc = 0;
+    uint8_t bit;
+
+    while (len-- > 0)
+    {
+        crc ^= *bytes++;
+        for (bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
@@ -0,0 +1,23 @@
+#ifndef CRC8_H_
+#define CRC8_H_
+
+/**********************************************************
+ *
+ * crc8.h
+ *
+ * CRC-8 (polynomial 0x07, initial value 0), as used to check
+ * step log records and telemetry frames.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    10th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+
+// *******************************************************
+// crc8: CRC of len bytes.
+uint8_t
+crc8 (const uint8_t *bytes, uint8_t len);
+
+#endif /* CRC8_H_ */
@@ -0,0 +1,94 @@
+/**********************************************************
+ *
+ * displayShadow.c
+ *
+ * Shadow text buffer for the Orbit OLED, see
+ * displayShadow.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    27th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "../OrbitOLED/OrbitOLEDInterface.h"
+#include "displayShadow.h"
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static char wanted[DISPLAY_ROWS][DISPLAY_COLS];     // Written by the caller
+static char shown[DISPLAY_ROWS][DISPLAY_COLS];      // Last sent to the OLED
+
+void
+initDisplayShadow (void)
+{
+    memset (wanted, ' ', sizeof (wanted));
+    memset (shown, ' ', sizeof (shown));
+}
+
+void
+writeDisplayText (const char *text, uint8_t col, uint8_t row)
+{
+    if (row >= DISPLAY_ROWS)
+        return;
+    while (*text != '\0' && col < DISPLAY_COLS)
+        wanted[row][col++] = *text++;
+}
+
+void
+writeDisplayLine (const char *text, uint8_t row)
+{
+    uint8_t col = 0;
+
+    if (row >= DISPLAY_ROWS)
+        return;
+    while (*text != '\0' && col < DISPLAY_COLS)
+        wanted[row][col++] = *text++;
+    while (col < DISPLAY_COLS)
+        wanted[row][col++] = ' ';
+}
+
+/*********************************************************
+ * flushDisplay: runs of changed characters are merged when
+ * no more than DISPLAY_RUN_GAP unchanged ones lie between,
+ * as resending those is cheaper than another draw call.
+ *********************************************************/
+uint16_t
+flushDisplay (void)
+{
+    char run[DISPLAY_COLS + 1];
+    uint16_t sent = 0;
+    uint8_t row;
+    uint8_t col;
+    uint8_t start;
+    uint8_t end;        // One past the last changed character of the run
+
+    for (row = 0; row < DISPLAY_ROWS; row++)
+    {
+        col = 0;
+        while (col < DISPLAY_COLS)
+        {
+            if (wanted[row][col] == shown[row][col])
+            {
+                col++;
+                continue;
+            }
+            start = col;
+            end = col + 1;
+            for (col = end; col < DISPLAY_COLS && col <= end + DISPLAY_RUN_GAP; col++)
+                if (wanted[row][col] != shown[row][col])
+                    end = col + 1;
+            col = end;
+
+            memcpy (run, &wanted[row][start], end - start);
+            run[end - start] = '\0';
+            memcpy (&shown[row][start], run, end - start);
+            OLEDStringDraw (run, start, row);
+            sent += end - start;
+        }
+    }
+    return sent;
+}
@@ -0,0 +1,54 @@
+#ifndef DISPLAYSHADOW_H_
+#define DISPLAYSHADOW_H_
+
+/**********************************************************
+ *
+ * displayShadow.h
+ *
+ * Shadow text buffer for the 4 x 16 character Orbit OLED.
+ * Text is written into the shadow. flushDisplay() then
+ * sends only the characters that differ from what the OLED
+ * already shows, as short runs, so the display traffic
+ * follows what actually changed rather than how often
+ * lines are rewritten. Nothing is blanked first, which
+ * removes the flicker.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    27th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+#define DISPLAY_ROWS        4
+#define DISPLAY_COLS        16
+#define DISPLAY_RUN_GAP     2   // Unchanged characters merged into a run
+
+// *******************************************************
+// initDisplayShadow: Blanks the shadow. The OLED must have
+// just been initialised (and so be blank).
+void
+initDisplayShadow (void);
+
+// *******************************************************
+// writeDisplayText: Writes text into the shadow at col, row,
+// clipped to the line.
+void
+writeDisplayText (const char *text, uint8_t col, uint8_t row);
+
+// *******************************************************
+// writeDisplayLine: Replaces a whole line, padding with
+// spaces.
+void
+writeDisplayLine (const char *text, uint8_t row);
+
+// *******************************************************
+// flushDisplay: Sends the changed characters to the OLED.
+// Returns the number of characters sent.
+uint16_t
+flushDisplay (void);
+
+#endif /* DISPLAYSHADOW_H_ */
@@ -0,0 +1,190 @@
+/**********************************************************
+ *
+ * firFilter.c
+ *
+ * Block FIR filter with decimation. See firFilter.h.
+ *
+ * The newest block is copied in after the last num_taps - 1
+ * inputs. Each output is then a dot product of the
+ * coefficients with a contiguous window of state. The window
+ * and coefficients are both read as packed pairs of int16_t
+ * and multiplied with SMLAD on the Cortex-M4.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    5th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "firFilter.h"
+
+/**********************************************************
+ * Dual 16-bit multiply-accumulate
+ **********************************************************/
+// FIR_MAC2: acc + lo(a) * lo(b) + hi(a) * hi(b), with a and b
+// each holding two int16_t.
+#if defined(HOST_BUILD)
+// Each product fits an int32_t but the sums need not, so they are
+// made in uint32_t and wrap the way SMLAD does.
+static inline int32_t
+firMac2 (uint32_t a, uint32_t b, int32_t acc)
+{
+    uint32_t sum = (uint32_t) acc;
+
+    sum += (uint32_t) ((int32_t) (int16_t) a * (int16_t) b);
+    sum += (uint32_t) ((int32_t) (int16_t) (a >> 16) * (int16_t) (b >> 16));
+    return (int32_t) sum;
+}
+#define FIR_MAC2(a, b, acc)     firMac2 ((a), (b), (acc))
+#elif defined(__TI_ARM__) || defined(__TMS470__)
+#define FIR_MAC2(a, b, acc)     _smlad ((a), (b), (acc))
+#else
+static inline int32_t
+firMac2 (uint32_t a, uint32_t b, int32_t acc)
+{
+    __asm ("smlad %0, %1, %2, %0" : "+r" (acc) : "r" (a), "r" (b));
+    return acc;
+}
+#define FIR_MAC2(a, b, acc)     firMac2 ((a), (b), (acc))
+#endif
+
+// Two int16_t as one word. The window can start on an odd
+// sample; the M4 allows an unaligned LDR and the compilers
+// turn this into one.
+static inline uint32_t
+readPair (const int16_t *p)
+{
+    uint32_t pair;
+
+    memcpy (&pair, p, sizeof (pair));
+    return pair;
+}
+
+/**********************************************************
+ * Coefficients
+ **********************************************************/
+const int16_t fir_lowpass_16[FIR_LOWPASS_16_TAPS] = {
+    0, 183, 259, -541, -1665, 0, 6025, 12123,
+    12123, 6025, 0, -1665, -541, 259, 183, 0
+};
+
+/*********************************************************
+ * initFir
+ *********************************************************/
+void
+initFir (firFilter_t *filter, const int16_t *coeffs, uint8_t num_taps,
+         uint8_t decimation)
+{
+    filter->coeffs = coeffs;
+    filter->num_taps = num_taps;
+    filter->decimation = decimation ? decimation : 1;
+    filter->phase = filter->decimation;
+    memset (filter->state, 0, sizeof (filter->state));
+}
+
+/*********************************************************
+ * firOutput: One output from the window starting at x.
+ *********************************************************/
+static int16_t
+firOutput (const int16_t *coeffs, uint8_t num_taps, const int16_t *x)
+{
+    int32_t acc = 1 << 14;      // Rounds the Q15 result
+    uint8_t k;
+
+    for (k = 0; k < num_taps; k += 2)
+        acc = FIR_MAC2 (readPair (&x[k]), readPair (&coeffs[k]), acc);
+    acc >>= 15;
+    if (acc > INT16_MAX)
+        return INT16_MAX;
+    if (acc < INT16_MIN)
+        return INT16_MIN;
+    return (int16_t) acc;
+}
+
+/*********************************************************
+ * firBlock
+ *********************************************************/
+uint16_t
+firBlock (firFilter_t *filter, const int16_t *in, uint16_t count,
+          int16_t *out)
+{
+    int16_t *block = &filter->state[filter->num_taps - 1];
+    uint16_t outputs = 0;
+    uint16_t chunk;
+    uint16_t i;
+
+    while (count > 0)
+    {
+        chunk = (count < FIR_MAX_BLOCK) ? count : FIR_MAX_BLOCK;
+        memcpy (block, in, chunk * sizeof (int16_t));
+        for (i = 0; i < chunk; i++)
+        {
+            if (--filter->phase == 0)
+            {
+                // Window ends at block[i], the newest input
+                out[outputs++] = firOutput (filter->coeffs, filter->num_taps,
+                                            &filter->state[i]);
+                filter->phase = filter->decimation;
+            }
+        }
+        // Keep the last num_taps - 1 inputs for the next pass
+        memmove (filter->state, &filter->state[chunk],
+                 (filter->num_taps - 1) * sizeof (int16_t));
+        in += chunk;
+        count -= chunk;
+    }
+    return outputs;
+}
+
+/*********************************************************
+ * initFirV
+ *********************************************************/
+void
+initFirV (firFilterV_t *filter, const int16_t *coeffs, uint8_t num_taps,
+          uint8_t decimation)
+{
+    uint8_t axis;
+
+    for (axis = 0; axis < 3; axis++)
+        initFir (&filter->axis[axis], coeffs, num_taps, decimation);
+}
+
+/*********************************************************
+ * firBlockV
+ *********************************************************/
+uint16_t
+firBlockV (firFilterV_t *filter, const vector3_t *in, uint16_t count,
+           vector3_t *out)
+{
+    int16_t axis_in[3][FIR_MAX_BLOCK];
+    int16_t axis_out[3][FIR_MAX_BLOCK];
+    uint16_t outputs = 0;
+    uint16_t chunk, made;
+    uint16_t i;
+
+    while (count > 0)
+    {
+        chunk = (count < FIR_MAX_BLOCK) ? count : FIR_MAX_BLOCK;
+        for (i = 0; i < chunk; i++)
+        {
+            axis_in[0][i] = in[i].x;
+            axis_in[1][i] = in[i].y;
+            axis_in[2][i] = in[i].z;
+        }
+        // The axes share a phase, so each makes the same number
+        made = firBlock (&filter->axis[0], axis_in[0], chunk, axis_out[0]);
+        firBlock (&filter->axis[1], axis_in[1], chunk, axis_out[1]);
+        firBlock (&filter->axis[2], axis_in[2], chunk, axis_out[2]);
+        for (i = 0; i < made; i++)
+        {
+            out[outputs + i].x = axis_out[0][i];
+            out[outputs + i].y = axis_out[1][i];
+            out[outputs + i].z = axis_out[2][i];
+        }
+        outputs += made;
+        in += chunk;
+        count -= chunk;
+    }
+    return outputs;
+}
@@ -0,0 +1,82 @@
+#ifndef FIRFILTER_H_
+#define FIRFILTER_H_
+
+/**********************************************************
+ *
+ * firFilter.h
+ *
+ * Block FIR filter with optional decimation, for int16_t
+ * accelerometer streams. Samples are filtered a FIFO batch
+ * at a time, and only the outputs that are kept after
+ * decimation are calculated.
+ *
+ * Coefficients are Q15. The taps are taken two at a time.
+ * On the Cortex-M4 each pair is a single SMLAD (dual 16-bit
+ * multiply-accumulate). Elsewhere, and on the host, the same
+ * sums are done in plain C. Both give the same result.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    5th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include "vector3.h"
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+#define FIR_MAX_TAPS    32      // Even
+#define FIR_MAX_BLOCK   32      // Input samples handled per pass
+
+// 16 tap low-pass, cut-off 0.2 fs, Hamming window, unity DC gain.
+// Suits decimation by 2 (e.g. a 200 Hz stream down to 100 Hz).
+#define FIR_LOWPASS_16_TAPS 16
+extern const int16_t fir_lowpass_16[FIR_LOWPASS_16_TAPS];
+
+// *******************************************************
+// Filter structures
+typedef struct {
+    const int16_t *coeffs;      // Q15. coeffs[0] weights the oldest sample
+    uint8_t num_taps;           // Even, up to FIR_MAX_TAPS
+    uint8_t decimation;         // Keep one output in this many
+    uint8_t phase;              // Inputs left until the next output
+    int16_t state[FIR_MAX_TAPS - 1 + FIR_MAX_BLOCK];
+                                // Last num_taps - 1 inputs, then the block
+} firFilter_t;
+
+typedef struct {
+    firFilter_t axis[3];        // x, y, z with the same coefficients
+} firFilterV_t;
+
+// *******************************************************
+// initFir: Sets the coefficients and decimation factor and
+// clears the history. An odd num_taps must be padded with a
+// zero coefficient to make it even.
+void
+initFir (firFilter_t *filter, const int16_t *coeffs, uint8_t num_taps,
+         uint8_t decimation);
+
+// *******************************************************
+// firBlock: Filters count input samples, writing one output
+// for every decimation inputs. Returns the number of outputs,
+// at most count / decimation + 1. in and out may be the same
+// buffer.
+uint16_t
+firBlock (firFilter_t *filter, const int16_t *in, uint16_t count,
+          int16_t *out);
+
+// *******************************************************
+// initFirV: initFir() for each axis of a vector3_t stream.
+void
+initFirV (firFilterV_t *filter, const int16_t *coeffs, uint8_t num_taps,
+          uint8_t decimation);
+
+// *******************************************************
+// firBlockV: firBlock() for each axis of a vector3_t
+// stream. in and out may be the same buffer.
+uint16_t
+firBlockV (firFilterV_t *filter, const vector3_t *in, uint16_t count,
+           vector3_t *out);
+
+#endif /* FIRFILTER_H_ */
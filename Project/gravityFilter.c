@@ -0,0 +1,112 @@
+/**********************************************************
+ *
+ * gravityFilter.c
+ *
+ * Complementary gravity estimate with lazily computed pitch
+ * and roll, see gravityFilter.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "orientFixed.h"
+#include "gravityFilter.h"
+
+#define GRAV_HALF   (1 << (GRAV_FRAC_BITS - 1))
+
+void
+initGravityFilter (gravityFilter_t *filter)
+{
+    filter->g[0] = filter->g[1] = filter->g[2] = 0;
+    filter->primed = false;
+    filter->angles_valid = false;
+}
+
+void
+updateGravityFilter (gravityFilter_t *filter, vector3_t sample)
+{
+    uint32_t mag_sq = magnitudeSq (sample);
+    uint8_t shift = GRAV_SHIFT_STILL;
+
+    if (!filter->primed)
+    {
+        filter->g[0] = (int32_t) sample.x << GRAV_FRAC_BITS;
+        filter->g[1] = (int32_t) sample.y << GRAV_FRAC_BITS;
+        filter->g[2] = (int32_t) sample.z << GRAV_FRAC_BITS;
+        filter->primed = true;
+    }
+    else
+    {
+        if (mag_sq < GRAV_TRUST_LOW || mag_sq > GRAV_TRUST_HIGH)
+            shift = GRAV_SHIFT_MOVING;  // Mostly not gravity
+        filter->g[0] += (((int32_t) sample.x << GRAV_FRAC_BITS) - filter->g[0])
+                        >> shift;
+        filter->g[1] += (((int32_t) sample.y << GRAV_FRAC_BITS) - filter->g[1])
+                        >> shift;
+        filter->g[2] += (((int32_t) sample.z << GRAV_FRAC_BITS) - filter->g[2])
+                        >> shift;
+    }
+    filter->angles_valid = false;
+}
+
+vector3_t
+getGravity (const gravityFilter_t *filter)
+{
+    vector3_t g;
+
+    g.x = (filter->g[0] + GRAV_HALF) >> GRAV_FRAC_BITS;
+    g.y = (filter->g[1] + GRAV_HALF) >> GRAV_FRAC_BITS;
+    g.z = (filter->g[2] + GRAV_HALF) >> GRAV_FRAC_BITS;
+    return g;
+}
+
+/*********************************************************
+ * updateAngles: pitchCentideg() and rollCentideg() on the
+ * estimate with its fraction bits kept. Scaling all three
+ * axes alike leaves both angles unchanged; the shift only
+ * keeps them within the 16 bits the routines take.
+ *********************************************************/
+static void
+updateAngles (gravityFilter_t *filter)
+{
+    vector3_t g;
+    uint8_t shift = GRAV_FRAC_BITS;
+    int32_t largest = 0;
+    uint8_t axis;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        if (filter->g[axis] > largest)
+            largest = filter->g[axis];
+        if (-filter->g[axis] > largest)
+            largest = -filter->g[axis];
+    }
+    while (shift > 0 && (largest >> shift) < 0x2000)
+        shift--;
+
+    g.x = filter->g[0] >> shift;
+    g.y = filter->g[1] >> shift;
+    g.z = filter->g[2] >> shift;
+    filter->pitch = pitchCentideg (g);
+    filter->roll = rollCentideg (g);
+    filter->angles_valid = true;
+}
+
+int16_t
+gravityPitch (gravityFilter_t *filter)
+{
+    if (!filter->angles_valid)
+        updateAngles (filter);
+    return filter->pitch;
+}
+
+int16_t
+gravityRoll (gravityFilter_t *filter)
+{
+    if (!filter->angles_valid)
+        updateAngles (filter);
+    return filter->roll;
+}
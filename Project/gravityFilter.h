@@ -0,0 +1,83 @@
+#ifndef GRAVITYFILTER_H_
+#define GRAVITYFILTER_H_
+
+/**********************************************************
+ *
+ * gravityFilter.h
+ *
+ * Incremental estimate of the gravity vector, from which
+ * pitch and roll are worked out only when asked for.
+ *
+ * There is no gyro, so the complementary filter weighs each
+ * accelerometer sample by how much it can be trusted. It
+ * is a first order low pass,
+ *
+ *     g += (a - g) / 2^shift
+ *
+ * with shift GRAV_SHIFT_STILL while |a| is near 1 g, and
+ * the slower GRAV_SHIFT_MOVING while it is not, as during a
+ * footfall. That is three subtractions, shifts and adds per
+ * sample, plus the three multiplies of |a|^2. g is held with
+ * GRAV_FRAC_BITS fraction bits, so small corrections are
+ * not lost to rounding.
+ *
+ * gravityPitch() and gravityRoll() run the atan2 of
+ * orientFixed.c on the estimate, and keep the result until
+ * the next update. host/gravityReport.c compares the noise
+ * and cost with per-sample calcPitch()/calcRoll().
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vector3.h"
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+#define GRAV_FRAC_BITS      8
+#define GRAV_SHIFT_STILL    4       // Time constant 16 samples (160 ms)
+#define GRAV_SHIFT_MOVING   6       // 64 samples (640 ms)
+#define GRAV_ONE_G          256     // Counts per g, full resolution
+#define GRAV_TRUST_LOW      (GRAV_ONE_G * GRAV_ONE_G * 16 / 25)  // (0.8 g)^2
+#define GRAV_TRUST_HIGH     (GRAV_ONE_G * GRAV_ONE_G * 36 / 25)  // (1.2 g)^2
+
+// *******************************************************
+// Filter structure
+typedef struct {
+    int32_t g[3];           // x, y, z in counts << GRAV_FRAC_BITS
+    bool primed;            // g holds at least one sample
+    bool angles_valid;      // pitch and roll are for the current g
+    int16_t pitch;          // Centidegrees
+    int16_t roll;
+} gravityFilter_t;
+
+// *******************************************************
+// initGravityFilter: Empties the filter. The first sample
+// then sets the estimate directly.
+void
+initGravityFilter (gravityFilter_t *filter);
+
+// *******************************************************
+// updateGravityFilter: Folds in one sample.
+void
+updateGravityFilter (gravityFilter_t *filter, vector3_t sample);
+
+// *******************************************************
+// getGravity: The estimate, rounded to counts.
+vector3_t
+getGravity (const gravityFilter_t *filter);
+
+// *******************************************************
+// gravityPitch, gravityRoll: Angles of the estimate in
+// centidegrees, as pitchCentideg() and rollCentideg().
+int16_t
+gravityPitch (gravityFilter_t *filter);
+
+int16_t
+gravityRoll (gravityFilter_t *filter);
+
+#endif /* GRAVITYFILTER_H_ */
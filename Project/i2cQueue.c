@@ -0,0 +1,241 @@
+/**********************************************************
+ *
+ * i2cQueue.c
+ *
+ * Interrupt driven, non-blocking I2C0 master, see
+ * i2cQueue.h. Each I2C0 interrupt marks the end of one byte
+ * on the bus; the handler issues the next command of the
+ * current transaction, or starts the next transaction.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    14th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+#include "driverlib/i2c.h"
+#include "driverlib/interrupt.h"
+#include "i2c_driver.h"
+#include "i2cQueue.h"
+#include "profile.h"
+
+enum i2cStates {I2C_IDLE = 0, I2C_SENT_REG, I2C_WRITING, I2C_READING, I2C_FINISHING};
+
+typedef struct {
+    i2cTransaction_t transaction;
+    uint8_t inline_data[I2C_INLINE_BYTES];
+} i2cSlot_t;
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static i2cSlot_t queue[I2C_QUEUE_SIZE];
+static volatile uint8_t q_head;         // Slot of the running transaction
+static volatile uint8_t q_count;
+static volatile uint8_t state;
+static uint8_t byte_index;
+static volatile uint32_t errors;
+
+/*********************************************************
+ * startTransaction: sends the register address, which
+ * every transaction begins with.
+ *********************************************************/
+static void
+startTransaction (void)
+{
+    i2cTransaction_t *t = &queue[q_head].transaction;
+
+    byte_index = 0;
+    I2CMasterSlaveAddrSet (I2C0_BASE, t->addr, WRITE);
+    I2CMasterDataPut (I2C0_BASE, t->reg);
+    if (!t->read && t->len == 0)
+    {
+        I2CMasterControl (I2C0_BASE, I2C_MASTER_CMD_SINGLE_SEND);
+        state = I2C_FINISHING;
+    }
+    else
+    {
+        I2CMasterControl (I2C0_BASE, I2C_MASTER_CMD_BURST_SEND_START);
+        state = I2C_SENT_REG;
+    }
+}
+
+/*********************************************************
+ * finishTransaction: reports the result, frees the slot
+ * and moves on to the next transaction, if any.
+ *********************************************************/
+static void
+finishTransaction (bool ok)
+{
+    i2cTransaction_t t = queue[q_head].transaction;
+
+    q_head = (q_head + 1) % I2C_QUEUE_SIZE;
+    q_count--;
+    state = I2C_IDLE;
+    if (!ok)
+        errors++;
+
+    if (t.callback != NULL)
+        t.callback (t.arg, ok);   // May submit more work
+
+    if (state == I2C_IDLE && q_count > 0)
+        startTransaction ();
+}
+
+/*********************************************************
+ * serviceI2C: moves the transaction at the head of the
+ * queue on by one bus command.
+ *********************************************************/
+static void
+serviceI2C (void)
+{
+    i2cTransaction_t *t = &queue[q_head].transaction;
+
+    I2CMasterIntClear (I2C0_BASE);
+
+    if (state == I2C_IDLE)
+        return;
+
+    if (I2CMasterErr (I2C0_BASE) != I2C_MASTER_ERR_NONE)
+    {
+        I2CMasterControl (I2C0_BASE, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+        finishTransaction (false);
+        return;
+    }
+
+    switch (state)
+    {
+    case I2C_SENT_REG:
+        if (t->read)
+        {
+            // Repeated start in receive mode.
+            I2CMasterSlaveAddrSet (I2C0_BASE, t->addr, READ);
+            if (t->len == 1)
+                I2CMasterControl (I2C0_BASE, I2C_MASTER_CMD_SINGLE_RECEIVE);
+            else
+                I2CMasterControl (I2C0_BASE, I2C_MASTER_CMD_BURST_RECEIVE_START);
+            state = I2C_READING;
+            break;
+        }
+        // Fall through to send the first data byte.
+    case I2C_WRITING:
+        I2CMasterDataPut (I2C0_BASE, t->data[byte_index++]);
+        if (byte_index == t->len)
+        {
+            I2CMasterControl (I2C0_BASE, I2C_MASTER_CMD_BURST_SEND_FINISH);
+            state = I2C_FINISHING;
+        }
+        else
+        {
+            I2CMasterControl (I2C0_BASE, I2C_MASTER_CMD_BURST_SEND_CONT);
+            state = I2C_WRITING;
+        }
+        break;
+
+    case I2C_READING:
+        t->data[byte_index++] = (uint8_t) I2CMasterDataGet (I2C0_BASE);
+        if (byte_index == t->len)
+            finishTransaction (true);
+        else if (byte_index == t->len - 1)
+            I2CMasterControl (I2C0_BASE, I2C_MASTER_CMD_BURST_RECEIVE_FINISH);
+        else
+            I2CMasterControl (I2C0_BASE, I2C_MASTER_CMD_BURST_RECEIVE_CONT);
+        break;
+
+    case I2C_FINISHING:
+        finishTransaction (true);
+        break;
+    }
+}
+
+/*********************************************************
+ * I2C0 interrupt handler
+ *********************************************************/
+void
+I2C0IntHandler (void)
+{
+    PROFILE_BEGIN (PROF_I2C_ISR);
+    serviceI2C ();
+    PROFILE_END (PROF_I2C_ISR);
+}
+
+/*********************************************************
+ * initI2CQueue
+ *********************************************************/
+void
+initI2CQueue (void)
+{
+    q_head = 0;
+    q_count = 0;
+    state = I2C_IDLE;
+    errors = 0;
+
+    I2CMasterIntClear (I2C0_BASE);
+    I2CMasterIntEnable (I2C0_BASE);
+    IntEnable (INT_I2C0);
+}
+
+/*********************************************************
+ * submitI2C
+ *********************************************************/
+bool
+submitI2C (const i2cTransaction_t *transaction)
+{
+    bool was_masked = IntMasterDisable ();
+    i2cSlot_t *slot;
+
+    if (q_count == I2C_QUEUE_SIZE)
+    {
+        if (!was_masked)
+            IntMasterEnable ();
+        return false;
+    }
+
+    slot = &queue[(q_head + q_count) % I2C_QUEUE_SIZE];
+    slot->transaction = *transaction;
+    if (!transaction->read && transaction->len <= I2C_INLINE_BYTES)
+    {
+        memcpy (slot->inline_data, transaction->data, transaction->len);
+        slot->transaction.data = slot->inline_data;
+    }
+    q_count++;
+
+    if (state == I2C_IDLE)
+        startTransaction ();
+
+    if (!was_masked)
+        IntMasterEnable ();
+    return true;
+}
+
+bool
+writeI2CReg (uint8_t addr, uint8_t reg, uint8_t value)
+{
+    i2cTransaction_t t;
+
+    t.addr = addr;
+    t.reg = reg;
+    t.read = WRITE;
+    t.len = 1;
+    t.data = &value;            // Copied into the queue slot
+    t.callback = NULL;
+    t.arg = NULL;
+    return submitI2C (&t);
+}
+
+bool
+isI2CIdle (void)
+{
+    return q_count == 0;
+}
+
+uint32_t
+i2cErrors (void)
+{
+    return errors;
+}
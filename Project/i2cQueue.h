@@ -0,0 +1,79 @@
+#ifndef I2CQUEUE_H_
+#define I2CQUEUE_H_
+
+/**********************************************************
+ *
+ * i2cQueue.h
+ *
+ * Interrupt driven, non-blocking I2C0 master. Register
+ * reads and writes are queued as transactions and carried
+ * out one byte per I2C0 interrupt, so the CPU is free while
+ * the bus is busy. A transaction's callback runs from the
+ * I2C0 interrupt when it completes (or fails).
+ *
+ * Bus and pin set-up is still done by the caller, as in
+ * initAccl(); see i2c_driver.h for the pin definitions.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    14th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+#define I2C_QUEUE_SIZE      16  // Transactions waiting or in progress
+#define I2C_INLINE_BYTES    4   // Writes up to this size are copied
+
+typedef void (*i2cCallback_t) (void *arg, bool ok);
+
+typedef struct {
+    uint8_t addr;               // 7-bit slave address
+    uint8_t reg;                // Register address, sent first
+    bool read;                  // READ or WRITE (i2c_driver.h)
+    uint8_t len;                // Bytes to read or write after reg
+    uint8_t *data;              // Read destination, or write source if
+                                // len > I2C_INLINE_BYTES. Must stay valid
+                                // until the callback.
+    i2cCallback_t callback;     // May be NULL
+    void *arg;
+} i2cTransaction_t;
+
+// *******************************************************
+// initI2CQueue: Empties the queue and enables the I2C0
+// master interrupt. I2C0 must already be initialised.
+void
+initI2CQueue (void);
+
+// *******************************************************
+// submitI2C: Queues a copy of the transaction and starts it
+// if the bus is idle. Safe from thread mode and from
+// callbacks. Returns false if the queue is full.
+bool
+submitI2C (const i2cTransaction_t *transaction);
+
+// *******************************************************
+// writeI2CReg: Queues a single register write.
+bool
+writeI2CReg (uint8_t addr, uint8_t reg, uint8_t value);
+
+// *******************************************************
+// isI2CIdle: True when no transaction is queued or running.
+bool
+isI2CIdle (void);
+
+// *******************************************************
+// i2cErrors: Transactions that ended with a bus error.
+uint32_t
+i2cErrors (void);
+
+// *******************************************************
+// I2C0IntHandler: I2C0 interrupt handler, installed in the
+// vector table in tm4c123gh6pm_startup_ccs.c.
+void
+I2C0IntHandler (void);
+
+#endif /* I2CQUEUE_H_ */
@@ -12,76 +12,295 @@
 
 // Imports
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib/sysctl.h"
+#include "driverlib/interrupt.h"
+#include "../OrbitOLED/OrbitOLEDInterface.h"
 #include "acc.h"
 #include "i2c_driver.h"
 #include "buttons4.h"
-#include "circBufT.h"
+#include "buttonEvents.h"
 #include "readAcc.h"
+#include "movingAvg.h"
+#include "stepDetect.h"
+#include "stepLog.h"
 #include "readRollPitch.h"
+#include "orientFixed.h"
+#include "gravityFilter.h"
+#include "scheduler.h"
+#include "displayShadow.h"
+#include "profile.h"
+#include "telemetry.h"
+#include "acclCal.h"
+#include "rtc.h"
 
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static int16_t mean_window[3][MEAN_WINDOW_MAX];
+static movingAvg_t x_mean;
+static movingAvg_t y_mean;
+static movingAvg_t z_mean;
+static stepDetect_t step_detector;
+static gravityFilter_t gravity;
+
+static bool reference_set;
+static int16_t relative_pitch;
+static int16_t relative_roll;
+
+static uint32_t log_s; //RTC second the log runs up to
+static uint32_t logged_steps;
 
 /********************************************************
- * main
+ * setReference: Takes the reference orientation that
+ * pitch and roll are shown relative to.
  ********************************************************/
-int
-main (void)
+static void
+setReference (vector3_t reference_acceleration)
 {
-    vector3_t acceleration_raw;
-    vector3_t acceleration_mean;
-    vector3_t reference_acceleration;
-    int8_t relative_pitch;
-    int8_t relative_roll;
+    relative_pitch = calcPitch(reference_acceleration, 0);
+    relative_roll = calcRoll(reference_acceleration, 0);
+    reference_set = true;
+}
+
+/********************************************************
+ * sampleTask: Starts pulling the FIFO over I2C once it is
+ * at its watermark. The samples arrive in the I2C0 ISR.
+ ********************************************************/
+static void
+sampleTask (void)
+{
+    PROFILE_BEGIN (PROF_ACCL);
+    drainAcclFifo();
+    PROFILE_END (PROF_ACCL);
+}
 
-    int32_t sum;
-    uint8_t butState;
-    uint16_t i;
+static bool
+samplesWaiting (void)
+{
+    const vector3_t *samples;
 
-    circBuf_t x_circ_buff;
-    circBuf_t y_circ_buff;
-    circBuf_t z_circ_buff;
+    return peekAcclSamples(&samples) > 0;
+}
 
-    initClock ();
-    initAccl ();
-    initDisplay ();
-    initButtons ();
+/********************************************************
+ * stepTask: Runs every drained sample through the filters
+ * and the step detector, in place in the queue. Each batch
+ * goes to telemetry with its timestamp and the count of
+ * samples missed so far.
+ ********************************************************/
+static void
+stepTask (void)
+{
+    const vector3_t *samples;
+    vector3_t sample;
+    uint8_t num_samples;
+    uint8_t cal_result;
+    uint8_t i;
 
-    initCircBuf (&x_circ_buff, BUFF_SIZE); //Initializing circular buffers for each axis
-    initCircBuf (&y_circ_buff, BUFF_SIZE);
-    initCircBuf (&z_circ_buff, BUFF_SIZE);
+    while ((num_samples = peekAcclSamples(&samples)) > 0) { //Used where the I2C0 ISR read them
+        if (!reference_set)
+            setReference (samples[0]); //Reference orientation is taken from the first FIFO batch
+        telemetryBatch (acclSampleTimes(samples)[0], num_samples, acclMissedSamples());
+        for (i = 0; i < num_samples; i++) { //Every sample goes through the filters in order
+            sample = samples[i];
+            {
+                PROFILE_BEGIN (PROF_MEAN);
+                updateMovingAvg (&x_mean, sample.x);
+                updateMovingAvg (&y_mean, sample.y);
+                updateMovingAvg (&z_mean, sample.z);
+                updateGravityFilter (&gravity, sample);
+                PROFILE_END (PROF_MEAN);
+            }
+            {
+                PROFILE_BEGIN (PROF_STEP);
+                if (updateStepDetect (&step_detector, sample))
+                    telemetryStep (getStepCount(&step_detector), schedMillis());
+                PROFILE_END (PROF_STEP);
+            }
+            cal_result = acclCalUpdate (sample);
+            if (cal_result == ACCL_CAL_DONE)
+                setReference (acclCalGravity()); //Averaged, and corrected by the new offsets
+            if (cal_result != ACCL_CAL_WAITING)
+                writeDisplayLine ("Orientation", 0); //Also if it timed out, steps still count
+            telemetryRaw (sample);
+        }
+        releaseAcclSamples (num_samples);
+    }
+}
 
-    OLEDStringDraw ("Orientation", 0, 0);
-    reference_acceleration = getAcclData();
-    relative_pitch = calcPitch(reference_acceleration, 0);
-    relative_roll = calcRoll(reference_acceleration, 0);
+/********************************************************
+ * buttonTask: Runs on new edges, and while a gesture is
+ * in progress in case it has timed out.
+ ********************************************************/
+static void
+buttonTask (void)
+{
+    buttonEvent_t button_event;
+
+    PROFILE_BEGIN (PROF_BUTTONS);
+    updateButtonEvents (schedMillis());
+
+    while (getButtonEvent (&button_event)) {
+        if (button_event.but == DOWN && button_event.type == BUT_SHORT) {
+            setReference (getGravity(&gravity)); //Resets reference orientation
+        } else if (button_event.but == DOWN && button_event.type == BUT_LONG) {
+            initStepDetect (&step_detector); //Holding DOWN zeroes the step count
+        } else if (button_event.but == UP && button_event.type == BUT_LONG) {
+            writeDisplayLine ("Calibrating", 0);
+            acclCalStart (); //Holding UP recalibrates once the device is still
+        }
+    }
+    schedEnable (SCHED_BUTTONS, buttonEventsBusy()); //Only times gestures in progress
+    PROFILE_END (PROF_BUTTONS);
+}
+
+/********************************************************
+ * displayTask: Shows pitch, roll and the step count, and
+ * queues the same figures for telemetry.
+ ********************************************************/
+static void
+displayTask (void)
+{
+    vector3_t acceleration_mean;
+    int16_t pitch;
+    int16_t roll;
+
+    acceleration_mean.x = getMovingAvg(&x_mean); //Mean of each axis, constant time
+    acceleration_mean.y = getMovingAvg(&y_mean);
+    acceleration_mean.z = getMovingAvg(&z_mean);
+
+    {
+        PROFILE_BEGIN (PROF_ORIENT);
+        pitch = centidegToDeg(gravityPitch(&gravity)) - relative_pitch; //Only worked out when shown
+        roll = centidegToDeg(gravityRoll(&gravity)) - relative_roll;
+        PROFILE_END (PROF_ORIENT);
+    }
 
-    while (1)
     {
-        SysCtlDelay (SysCtlClockGet () / 6);    // Approx 2 Hz
-        acceleration_raw = getAcclData();
+        PROFILE_BEGIN (PROF_DISPLAY);
+        //Display units = Degrees
+        displayUpdate ("Pitch", "Y", pitch, 1);
+        displayUpdate ("Roll", "X", roll, 2);
+        displayUpdate ("Step", "count", getStepCount(&step_detector), 3);
+        flushDisplay (); //Only characters that changed go to the OLED
+        PROFILE_END (PROF_DISPLAY);
+    }
+    telemetryFiltered (acceleration_mean, pitch, roll);
+    telemetryProfile (); //One stage per update, all of them every 2 s
+}
 
-        writeCircBuf (&x_circ_buff, acceleration_raw.x);
-        writeCircBuf (&y_circ_buff, acceleration_raw.y);
-        writeCircBuf (&z_circ_buff, acceleration_raw.z);
+/********************************************************
+ * telemetryTask: Sends whatever the other tasks queued in
+ * one uDMA transfer.
+ ********************************************************/
+static void
+telemetryTask (void)
+{
+    telemetryFlush ();
+}
 
-        updateButtons ();
+/********************************************************
+ * logTask: New steps go to flash once a minute, and as
+ * soon as the device stops moving, before it goes idle.
+ * Time is kept by the RTC, which runs on in deep sleep, so
+ * minutes without new steps, idle ones included, are
+ * added to the next record.
+ ********************************************************/
+static void
+logTask (void)
+{
+    uint32_t steps;
+    uint32_t now;
 
-        butState = checkButton (DOWN); //Gets the current state of the DOWN button
+    now = rtcSeconds();
+    if (acclIsActive() && now - log_s < STEPLOG_PERIOD_S)
+        return;
+    steps = getStepCount(&step_detector);
+    if (steps < logged_steps)
+        logged_steps = 0; //Count was zeroed since the last record
+    if (steps > logged_steps) {
+        stepLogAppend (now - log_s, steps - logged_steps);
+        logged_steps = steps;
+        log_s = now;
+    }
+}
 
-        if (butState == PUSHED) { /*Checks if the 'DOWN' button has been pushed
-                                    Note, button has to be held for a short period to trigger.*/
-            reference_acceleration = getAcclData();
-            relative_pitch = calcPitch(reference_acceleration, 0);
-            relative_roll = calcRoll(reference_acceleration, 0); //Resets reference orientation
-        }
+static bool
+stepsBeforeIdle (void)
+{
+    return !acclIsActive() && getStepCount(&step_detector) != logged_steps;
+}
 
+/********************************************************
+ * Task table, in schedTasks order. Budgets are for the
+ * 20 MHz target. The FIFO holds ACCL_FIFO_WATERMARK
+ * samples (160 ms) past its watermark, so sampling and
+ * the step task come first; a flash page erase in the log
+ * task takes up to 20 ms, so it goes last.
+ *   run, ready, rate_hz, deadline_ms, budget_us, priority
+ ********************************************************/
+static const schedTask_t tasks[NUM_SCHED_TASKS] = {
+    {sampleTask, acclFifoReady, 0, 20, 200, 0},
+    {stepTask, samplesWaiting, 0, 50, 2000, 1},
+    {buttonTask, buttonsChanged, BUTTON_RATE_HZ, 20, 200, 2},
+    {displayTask, NULL, DISPLAY_RATE_HZ, 1000 / DISPLAY_RATE_HZ, 5000, 3},
+    {telemetryTask, telemetryPending, 0, 100, 200, 4},
+    {logTask, stepsBeforeIdle, LOG_RATE_HZ, 1000 / LOG_RATE_HZ, 25000, 5}
+};
 
-        acceleration_mean.x = calcMean(sum, i, &x_circ_buff); //Calculates the mean for each axis using the values stored
-        acceleration_mean.y = calcMean(sum, i, &y_circ_buff); //in each circular buffer
-        acceleration_mean.z = calcMean(sum, i, &z_circ_buff);
+/********************************************************
+ * main
+ ********************************************************/
+int
+main (void)
+{
+    bool calibrated;
+    bool accl_started;
+    uint8_t task;
 
-        //Display units = Degrees
-        displayUpdate ("Pitch", "Y", calcPitch(acceleration_raw, relative_pitch), 1);
-        displayUpdate ("Roll", "X", calcRoll(acceleration_raw, relative_roll), 2);
+    initClock ();
+    initRtc (); //Seconds for the step log, counted in deep sleep too
+    calibrated = initAcclCal (); //Stored offsets, written to the ADXL345 by initAccl()
+    accl_started = initAccl (); //Queues the ADXL345 set-up, false if the I2C queue refused it
+    initDisplay ();
+    initButtons ();
+    initButtonInts (); //Edges start a debounce timer, nothing is polled
+    initButtonEvents ();
+
+    initMovingAvg (&x_mean, mean_window[0], MEAN_WINDOW_MAX, BUFF_SIZE); //Running-sum means, window
+    initMovingAvg (&y_mean, mean_window[1], MEAN_WINDOW_MAX, BUFF_SIZE); //can be widened at run time
+    initMovingAvg (&z_mean, mean_window[2], MEAN_WINDOW_MAX, BUFF_SIZE);
+    initStepDetect (&step_detector);
+    initGravityFilter (&gravity); //Smoothed gravity vector for pitch and roll
+    initStepLog (); //Recovers the flash log and marks the reset in it
+    initProfile (); //Compiled in only with PROFILE defined
+    initTelemetry (); //Framed records out of UART0, sent by uDMA
+
+    IntMasterEnable (); //Lets the queued accelerometer set-up go out on the I2C bus
+
+    writeDisplayLine (accl_started ? "Orientation" : "Accl set-up fail", 0);
+    relative_pitch = 0;
+    relative_roll = 0;
+    reference_set = false;
 
+    if (accl_started && !calibrated) {
+        writeDisplayLine ("Calibrating", 0);
+        acclCalStart (); //First still window sets the offsets
+    }
+
+    for (task = 0; task < NUM_SCHED_TASKS; task++)
+        schedAddTask (task, &tasks[task]);
+    initScheduler (); //Starts SysTick, periodic tasks run at the rates set in scheduler.h
+    schedEnable (SCHED_BUTTONS, false); //Until a button is pressed
+    log_s = rtcSeconds();
+    logged_steps = 0;
+
+    while (1)
+    {
+        schedRun (); //Every released task once, most urgent first
+        schedSetIdle (!acclIsActive() && !buttonEventsBusy()); //SysTick stops while the ADXL345 reports inactivity
+        schedWait (); //Sleeps until the next SysTick unless a task is already due
     }
 }
@@ -0,0 +1,64 @@
+/**********************************************************
+ *
+ * movingAvg.c
+ *
+ * Moving average filter with a running sum, see
+ * movingAvg.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    20th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include "movingAvg.h"
+
+void
+initMovingAvg (movingAvg_t *filter, int16_t *storage, uint16_t capacity,
+               uint16_t size)
+{
+    filter->window = storage;
+    filter->capacity = capacity;
+    setMovingAvgSize (filter, size);
+}
+
+void
+setMovingAvgSize (movingAvg_t *filter, uint16_t size)
+{
+    if (size < 1)
+        size = 1;
+    if (size > filter->capacity)
+        size = filter->capacity;
+    filter->size = size;
+    filter->index = 0;
+    filter->count = 0;
+    filter->sum = 0;
+}
+
+void
+updateMovingAvg (movingAvg_t *filter, int16_t value)
+{
+    if (filter->count == filter->size)
+        filter->sum -= filter->window[filter->index]; // Oldest sample leaves
+    else
+        filter->count++;
+
+    filter->sum += value;
+    filter->window[filter->index] = value;
+    filter->index++;
+    if (filter->index >= filter->size)
+        filter->index = 0;
+}
+
+int16_t
+getMovingAvg (const movingAvg_t *filter)
+{
+    int32_t half = filter->count / 2;
+
+    if (filter->count == 0)
+        return 0;
+    // Round half away from zero, for either sign of the sum.
+    if (filter->sum >= 0)
+        return (filter->sum + half) / filter->count;
+    return (filter->sum - half) / filter->count;
+}
@@ -0,0 +1,59 @@
+#ifndef MOVINGAVG_H_
+#define MOVINGAVG_H_
+
+/**********************************************************
+ *
+ * movingAvg.h
+ *
+ * Moving average filter with a running sum. Each update
+ * adds the new sample and subtracts the one leaving the
+ * window, so both updating and reading the mean take
+ * constant time whatever the window length. The window
+ * length can be changed at run time up to the capacity of
+ * the storage supplied by the caller.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    20th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+
+// *******************************************************
+// Filter structure
+typedef struct {
+    int16_t *window;        // Caller supplied storage, capacity entries
+    uint16_t capacity;      // Longest window the storage allows
+    uint16_t size;          // Current window length
+    uint16_t index;         // Next entry to overwrite, mod(size)
+    uint16_t count;         // Samples held, up to size
+    int32_t sum;            // Sum of the samples held
+} movingAvg_t;
+
+// *******************************************************
+// initMovingAvg: Attaches storage for up to capacity samples
+// and empties the filter, with a window of size samples.
+void
+initMovingAvg (movingAvg_t *filter, int16_t *storage, uint16_t capacity,
+               uint16_t size);
+
+// *******************************************************
+// setMovingAvgSize: Changes the window length (clamped to
+// 1..capacity) and empties the filter.
+void
+setMovingAvgSize (movingAvg_t *filter, uint16_t size);
+
+// *******************************************************
+// updateMovingAvg: Adds a sample, dropping the oldest one
+// once the window is full.
+void
+updateMovingAvg (movingAvg_t *filter, int16_t value);
+
+// *******************************************************
+// getMovingAvg: Mean of the samples held, rounded to the
+// nearest integer. Until the window has filled this is
+// the mean of the samples so far; 0 if there are none.
+int16_t
+getMovingAvg (const movingAvg_t *filter);
+
+#endif /* MOVINGAVG_H_ */
@@ -0,0 +1,75 @@
+/**********************************************************
+ *
+ * orientFixed.c
+ *
+ * Integer pitch and roll, see orientFixed.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    22nd of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include "orientFixed.h"
+#include "trigLut.h"
+
+uint32_t
+magnitudeSq (vector3_t acceleration)
+{
+    return (uint32_t) ((int32_t) acceleration.x * acceleration.x)
+         + (uint32_t) ((int32_t) acceleration.y * acceleration.y)
+         + (uint32_t) ((int32_t) acceleration.z * acceleration.z);
+}
+
+int16_t
+atan2Centideg (int32_t y, int32_t x)
+{
+    uint32_t ax = (x < 0) ? -x : x;
+    uint32_t ay = (y < 0) ? -y : y;
+    int32_t angle;
+
+    if (ay <= ax)
+        angle = atanLutCentideg (ay, ax);
+    else
+        angle = CENTIDEG_90 - atanLutCentideg (ax, ay);
+    if (x < 0)
+        angle = CENTIDEG_180 - angle;
+    return (y < 0) ? -angle : angle;
+}
+
+/*********************************************************
+ * pitchCentideg: the horizontal component and Y are scaled
+ * up together, while both stay in range, so the truncation
+ * of sqrtLut() to whole counts costs little accuracy on
+ * small readings.
+ *********************************************************/
+int16_t
+pitchCentideg (vector3_t acceleration)
+{
+    uint32_t horizontal = (uint32_t) ((int32_t) acceleration.x * acceleration.x)
+                        + (uint32_t) ((int32_t) acceleration.z * acceleration.z);
+    int32_t vertical = acceleration.y;
+    uint32_t limit = (vertical < 0) ? -vertical : vertical;
+
+    while (horizontal < (1UL << 28) && limit < 0x4000)
+    {
+        horizontal <<= 2;
+        vertical *= 2;
+        limit *= 2;
+    }
+    return atan2Centideg (vertical, sqrtLut (horizontal));
+}
+
+int16_t
+rollCentideg (vector3_t acceleration)
+{
+    return atan2Centideg (-(int32_t) acceleration.x, acceleration.z);
+}
+
+int16_t
+centidegToDeg (int32_t centideg)
+{
+    if (centideg >= 0)
+        return (centideg + CENTIDEG_PER_DEG / 2) / CENTIDEG_PER_DEG;
+    return (centideg - CENTIDEG_PER_DEG / 2) / CENTIDEG_PER_DEG;
+}
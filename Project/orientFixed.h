@@ -0,0 +1,63 @@
+#ifndef ORIENTFIXED_H_
+#define ORIENTFIXED_H_
+
+/**********************************************************
+ *
+ * orientFixed.h
+ *
+ * Integer pitch and roll from a three axis acceleration
+ * sample. Angles are in centidegrees (hundredths of a
+ * degree). atan2 reduces to the first octant and reads the
+ * interpolated table in trigLut.c. The magnitude comes from
+ * its inverse square root table. No floating point is
+ * used, so the whole calculation is a few dozen integer
+ * operations per sample.
+ *
+ * host/orientReport.c measures the accuracy against the
+ * double precision atan2.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    22nd of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include "vector3.h"
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+#define CENTIDEG_PER_DEG    100
+#define CENTIDEG_90         9000
+#define CENTIDEG_180        18000
+
+// *******************************************************
+// magnitudeSq: x^2 + y^2 + z^2 of a sample, in counts^2.
+uint32_t
+magnitudeSq (vector3_t acceleration);
+
+// *******************************************************
+// atan2Centideg: Angle of the vector (x, y) from the x axis,
+// -18000 to 18000 centidegrees. |x| and |y| must be below
+// 65536. atan2Centideg(0, 0) is 0.
+int16_t
+atan2Centideg (int32_t y, int32_t x);
+
+// *******************************************************
+// pitchCentideg: Rotation about the X axis, the angle of Y
+// above the XZ plane. -9000 to 9000.
+int16_t
+pitchCentideg (vector3_t acceleration);
+
+// *******************************************************
+// rollCentideg: Rotation about the Y axis, from Z towards
+// -X. -18000 to 18000.
+int16_t
+rollCentideg (vector3_t acceleration);
+
+// *******************************************************
+// centidegToDeg: Rounds to the nearest whole degree.
+int16_t
+centidegToDeg (int32_t centideg);
+
+#endif /* ORIENTFIXED_H_ */
@@ -0,0 +1,182 @@
+/**********************************************************
+ *
+ * profile.c
+ *
+ * Cycle profiling of the processing stages, see profile.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    2nd of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_types.h"
+#include "driverlib/sysctl.h"
+#include "utils/ustdlib.h"
+#include "profile.h"
+#ifdef HOST_BUILD
+#include <time.h>
+#endif
+
+#define DEMCR           0xE000EDFC
+#define DEMCR_TRCENA    0x01000000
+#define DWT_CTRL        0xE0001000
+#define DWT_CYCCNTENA   0x00000001
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static uint32_t ticks_per_us;
+
+#ifdef HOST_BUILD
+uint32_t
+profileNow (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint32_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+#endif
+
+void
+initProfileClock (void)
+{
+#ifdef HOST_BUILD
+    ticks_per_us = 1000;
+#else
+    ticks_per_us = SysCtlClockGet () / 1000000;
+    HWREG(DEMCR) |= DEMCR_TRCENA;       // Enables the DWT unit
+    HWREG(DWT_CTRL) |= DWT_CYCCNTENA;
+#endif
+}
+
+uint32_t
+profileTicksPerUs (void)
+{
+    return ticks_per_us;
+}
+
+#ifdef PROFILE
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t bins[PROFILE_BINS];
+} profileStage_t;
+
+static profileStage_t stages[NUM_PROF_STAGES];
+
+static const char *const stage_names[NUM_PROF_STAGES] = {
+    "accl", "mean", "step", "orient", "buttons", "display", "i2c_isr"
+};
+
+void
+initProfile (void)
+{
+    uint8_t stage;
+    uint8_t bin;
+
+    initProfileClock ();
+    for (stage = 0; stage < NUM_PROF_STAGES; stage++)
+    {
+        stages[stage].count = 0;
+        stages[stage].min = UINT32_MAX;
+        stages[stage].max = 0;
+        stages[stage].total = 0;
+        for (bin = 0; bin < PROFILE_BINS; bin++)
+            stages[stage].bins[bin] = 0;
+    }
+}
+
+// Index of the highest set bit, 0 for 0 and 1.
+static uint8_t
+log2Bin (uint32_t ticks)
+{
+    uint8_t bin = 0;
+
+    while ((ticks >>= 1) != 0)
+        bin++;
+    return (bin < PROFILE_BINS) ? bin : PROFILE_BINS - 1;
+}
+
+void
+profileRecord (uint8_t stage, uint32_t ticks)
+{
+    profileStage_t *s = &stages[stage];
+
+    s->count++;
+    s->total += ticks;
+    if (ticks < s->min)
+        s->min = ticks;
+    if (ticks > s->max)
+        s->max = ticks;
+    s->bins[log2Bin (ticks)]++;
+}
+
+void
+profileDump (profilePrint_t print)
+{
+    char line[80];
+    int len;
+    uint8_t stage;
+    uint8_t bin;
+    const profileStage_t *s;
+
+    usnprintf (line, sizeof (line), "profile, times in %s", PROFILE_UNITS);
+    print (line);
+    usnprintf (line, sizeof (line), "  %10s %8s %8s %8s %8s", "stage", "count",
+               "min", "mean", "max");
+    print (line);
+    for (stage = 0; stage < NUM_PROF_STAGES; stage++)
+    {
+        s = &stages[stage];
+        if (s->count == 0)
+            continue;
+        usnprintf (line, sizeof (line), "  %10s %8u %8u %8u %8u",
+                   stage_names[stage], (unsigned) s->count, (unsigned) s->min,
+                   (unsigned) (s->total / s->count), (unsigned) s->max);
+        print (line);
+    }
+    for (stage = 0; stage < NUM_PROF_STAGES; stage++)
+    {
+        s = &stages[stage];
+        if (s->count == 0)
+            continue;
+        len = usnprintf (line, sizeof (line), "  %8s", stage_names[stage]);
+        for (bin = 0; bin < PROFILE_BINS; bin++)
+        {
+            if (s->bins[bin] == 0)
+                continue;
+            if (len > (int) sizeof (line) - 16)
+            {
+                print (line);
+                len = usnprintf (line, sizeof (line), "  %8s", "");
+            }
+            len += usnprintf (line + len, sizeof (line) - len, " 2^%u:%u",
+                              (unsigned) bin, (unsigned) s->bins[bin]);
+        }
+        print (line);
+    }
+}
+
+bool
+profileStageSummary (uint8_t stage, uint32_t *count, uint32_t *min,
+                     uint32_t *mean, uint32_t *max)
+{
+    const profileStage_t *s;
+
+    if (stage >= NUM_PROF_STAGES || stages[stage].count == 0)
+        return false;
+    s = &stages[stage];
+    *count = s->count;
+    *min = s->min;
+    *mean = (uint32_t) (s->total / s->count);
+    *max = s->max;
+    return true;
+}
+
+#endif /* PROFILE */
@@ -0,0 +1,117 @@
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+/**********************************************************
+ *
+ * profile.h
+ *
+ * Cycle profiling of the processing stages. Wrap a stage in
+ * PROFILE_BEGIN(stage) and PROFILE_END(stage), in the same
+ * block. PROFILE_BEGIN declares a variable, so it has to
+ * come at the start of a block. The time between them is
+ * added to that stage's count, min, max, total and log2
+ * histogram, all held in a fixed static table.
+ * profileDump() prints the table a line at a time through a
+ * callback, and profileStageSummary() hands one stage's
+ * figures to the telemetry stream.
+ *
+ * On target the time comes from the Cortex-M4 DWT cycle
+ * counter. In the host build it comes from clock_gettime()
+ * in nanoseconds, and includes the time spent in the
+ * peripheral models.
+ *
+ * Profiling is compiled in only when PROFILE is defined.
+ * Otherwise every macro and call here expands to nothing,
+ * except the clock: profileNow(), initProfileClock() and
+ * profileTicksPerUs(). The scheduler times its tasks with
+ * them, so there is one owner of the cycle counter.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    2nd of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+#define PROFILE_BINS        24  // Histogram bins: [2^n, 2^(n+1)) ticks
+
+enum profileStages {PROF_ACCL = 0,      // FIFO drain start
+                    PROF_MEAN,          // Moving averages and gravity, per sample
+                    PROF_STEP,          // Step detector, per sample
+                    PROF_ORIENT,        // gravityPitch + gravityRoll
+                    PROF_BUTTONS,       // Handling a debounced change
+                    PROF_DISPLAY,       // displayUpdate x3 + flushDisplay
+                    PROF_I2C_ISR,       // I2C0IntHandler
+                    NUM_PROF_STAGES};
+
+typedef void (*profilePrint_t) (const char *line);
+
+#ifdef HOST_BUILD
+#define PROFILE_UNITS   "ns"
+uint32_t
+profileNow (void);
+#else
+#include "inc/hw_types.h"
+#define PROFILE_UNITS   "cycles"
+#define DWT_CYCCNT      0xE0001004
+#define profileNow()    HWREG(DWT_CYCCNT)
+#endif
+
+// *******************************************************
+// initProfileClock: Starts the cycle counter that
+// profileNow() reads. Call after initClock(); calling it
+// again does no harm.
+void
+initProfileClock (void);
+
+// *******************************************************
+// profileTicksPerUs: profileNow() ticks per microsecond.
+uint32_t
+profileTicksPerUs (void);
+
+#ifdef PROFILE
+
+#define PROFILE_BEGIN(stage) \
+    uint32_t profile_start_##stage = profileNow ()
+#define PROFILE_END(stage) \
+    profileRecord ((stage), profileNow () - profile_start_##stage)
+
+// *******************************************************
+// initProfile: Starts the cycle counter and clears the table.
+void
+initProfile (void);
+
+// *******************************************************
+// profileRecord: Adds one measurement of ticks to a stage.
+void
+profileRecord (uint8_t stage, uint32_t ticks);
+
+// *******************************************************
+// profileDump: Prints a summary line per stage, then the
+// non-empty histogram bins, through print.
+void
+profileDump (profilePrint_t print);
+
+// *******************************************************
+// profileStageSummary: Gets a stage's count, min, mean and
+// max. Returns false if the stage has not been timed yet.
+bool
+profileStageSummary (uint8_t stage, uint32_t *count, uint32_t *min,
+                     uint32_t *mean, uint32_t *max);
+
+#else
+
+#define PROFILE_BEGIN(stage)
+#define PROFILE_END(stage)
+#define initProfile()
+#define profileRecord(stage, ticks)
+#define profileDump(print)
+#define profileStageSummary(stage, count, min, mean, max) false
+
+#endif /* PROFILE */
+
+#endif /* PROFILE_H_ */
@@ -18,40 +18,112 @@
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "inc/hw_i2c.h"
+#include "inc/hw_ints.h"
 #include "driverlib/pin_map.h" //Needed for pin configure
 #include "driverlib/systick.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/gpio.h"
 #include "driverlib/i2c.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/timer.h"
 #include "../OrbitOLED/OrbitOLEDInterface.h"
 #include "utils/ustdlib.h"
 #include "acc.h"
 #include "i2c_driver.h"
+#include "i2cQueue.h"
 #include "buttons4.h"
 #include "circBufT.h"
+#include "readAcc.h"
+#include "scheduler.h"
+#include "displayShadow.h"
+#include "spscQueue.h"
+#include "acclCal.h"
 
-typedef struct vector{
-    int16_t x;
-    int16_t y;
-    int16_t z;
-} vector3_t;
-
-/**********************************************************
- * Constants
- **********************************************************/
-// Systick configuration
-#define SYSTICK_RATE_HZ    10
-#define BUFF_SIZE 10
-#define NUM_BITS 256
-#define GRAVITY 9.81
 /*******************************************
- *      Local prototypes
+ *      Globals to module
  *******************************************/
-void initClock (void);
-void initDisplay (void);
-void displayUpdate (char *str1, char *str2, int16_t num, uint8_t charLine);
-void initAccl (void);
-vector3_t getAcclData (void);
+static volatile bool accl_active = true;    // Last of ACTIVITY/INACTIVITY seen
+static vector3_t *fifo_slot;            // accl_queue slot the read lands in
+static vector3_t fifo_discard;          // Read target while accl_queue is full
+static uint8_t fifo_entries;            // Samples to pull in this drain
+static volatile uint8_t fifo_count;     // Samples pulled so far
+static volatile bool fifo_busy;         // Drain in progress
+static volatile bool fifo_int;          // Watermark interrupt seen, or a read to retry
+static uint32_t drain_time;             // When the newest sample of this drain converted
+#if ACCL_DATA_READY_MODE
+static volatile uint32_t ready_time;    // Last DATA_READY edge
+static volatile bool read_again;        // DATA_READY edge seen mid-read
+#else
+static uint8_t int_source;
+static uint8_t fifo_status;
+static bool fifo_overrun;               // OVERRUN set when this drain began
+#endif
+
+static uint32_t sample_period;          // Timer cycles between conversions
+static uint32_t last_time;              // Timestamp of the last sample read
+static bool have_last;
+static volatile uint32_t accl_missed;
+
+SPSC_DECLARE (accl_queue, ACCL_QUEUE_SIZE); // Filled by the I2C0 ISR, emptied by main()
+static uint32_t accl_times[ACCL_QUEUE_SIZE];    // Timestamp of each accl_queue slot
+
+// DATAX0..DATAZ1 are x, y and z as little endian int16, which is how a
+// little endian CPU lays out a vector3_t. FIFO reads go straight into
+// accl_queue slots with no decoding.
+typedef char vector3_layout_check[sizeof (vector3_t) == 6 ? 1 : -1];
+#if defined(__big_endian__) || defined(__BIG_ENDIAN__) \
+    || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define ACCL_SWAP_IN_PLACE
+#endif
+
+typedef struct {
+    uint8_t reg;
+    uint8_t value;
+} acclRegWrite_t;
+
+// ADXL345 set-up, written in order by initAccl() after the offsets.
+static const acclRegWrite_t accl_setup[] = {
+    // set +-2g, 13 bit resolution, active high interrupts
+    {ACCL_DATA_FORMAT, ACCL_RANGE_2G | ACCL_FULL_RES},
+#if ACCL_POWER_SAVE
+    {ACCL_BW_RATE, ACCL_LOW_POWER | ACCL_RATE_100HZ},
+#else
+    {ACCL_BW_RATE, ACCL_RATE_100HZ},
+#endif
+#if ACCL_DATA_READY_MODE
+    // Bypass mode: DATA_READY, mapped to INT2, rises as each sample
+    // converts and falls once the data registers are read.
+    {ACCL_FIFO_CTL, ACCL_FIFO_BYPASS},
+    {ACCL_INT_MAP, ACCL_INT_DATA_READY},
+    {ACCL_INT, ACCL_INT_DATA_READY},
+    {ACCL_PWR_CTL, ACCL_MEASURE},           // Start measuring last
+#else
+    // Stream mode: the FIFO keeps the newest 32 samples and raises the
+    // watermark interrupt, mapped to INT2, once ACCL_FIFO_WATERMARK are held.
+    {ACCL_FIFO_CTL, ACCL_FIFO_STREAM | ACCL_FIFO_WATERMARK},
+#if ACCL_POWER_SAVE
+    // Activity and inactivity, AC coupled on all axes, share INT2.
+    {ACCL_THRESH_ACT, ACCL_ACT_THRESH},
+    {ACCL_THRESH_INACT, ACCL_INACT_THRESH},
+    {ACCL_TIME_INACT, ACCL_INACT_TIME},
+    {ACCL_ACT_INACT_CTL, ACCL_ACT_AC | ACCL_ACT_X | ACCL_ACT_Y | ACCL_ACT_Z
+                         | ACCL_INACT_AC | ACCL_INACT_X | ACCL_INACT_Y | ACCL_INACT_Z},
+    {ACCL_INT_MAP, ACCL_INT_WATERMARK | ACCL_INT_ACTIVITY | ACCL_INT_INACTIVITY},
+    {ACCL_INT, ACCL_INT_WATERMARK | ACCL_INT_ACTIVITY | ACCL_INT_INACTIVITY},
+    {ACCL_PWR_CTL, ACCL_LINK | ACCL_AUTO_SLEEP | ACCL_MEASURE
+                   | ACCL_WAKEUP_8HZ},      // Start measuring last
+#else
+    {ACCL_INT_MAP, ACCL_INT_WATERMARK},
+    {ACCL_INT, ACCL_INT_WATERMARK},
+    {ACCL_PWR_CTL, ACCL_MEASURE},           // Start measuring last
+#endif
+#endif /* ACCL_DATA_READY_MODE */
+};
+#define ACCL_SETUP_WRITES   (sizeof (accl_setup) / sizeof (accl_setup[0]))
+
+// initAccl() queues the set-up and the three offsets before interrupts
+// are enabled, so all of them must fit in the I2C queue at once.
+typedef char accl_setup_check[ACCL_SETUP_WRITES + 3 <= I2C_QUEUE_SIZE ? 1 : -1];
 
 /***********************************************************
  * Initialisation functions: clock, SysTick, PWM
@@ -74,33 +146,38 @@ initDisplay (void)
 {
     // Initialise the Orbit OLED display
     OLEDInitialise ();
+    initDisplayShadow ();
 }
 
 //*****************************************************************************
 // Function to display a changing message on the display.
 // The display has 4 rows of 16 characters, with 0, 0 at top left.
+// The line goes into the shadow buffer; flushDisplay() sends what changed.
+// If the number is too wide to fit after both strings, str2 is left out.
 //*****************************************************************************
 void
-displayUpdate (char *str1, char *str2, int16_t num, uint8_t charLine)
+displayUpdate (char *str1, char *str2, int32_t num, uint8_t charLine)
 {
     char text_buffer[17];           //Display fits 16 characters wide.
 
-    // "Undraw" the previous contents of the line to be updated.
-    OLEDStringDraw ("                ", 0, charLine);
     // Form a new string for the line.  The maximum width specified for the
     //  number field ensures it is displayed right justified.
-    usnprintf(text_buffer, sizeof(text_buffer), "%s %s %3d", str1, str2, num);
-    // Update line on display.
-    OLEDStringDraw (text_buffer, 0, charLine);
+    if (usnprintf(text_buffer, sizeof(text_buffer), "%s %s %3d", str1, str2, num)
+            >= (int)sizeof(text_buffer))
+        usnprintf(text_buffer, sizeof(text_buffer), "%s %3d", str1, num);
+    // Padding the rest of the line replaces the old "undraw".
+    writeDisplayLine (text_buffer, charLine);
 }
 
 /*********************************************************
- * initAccl
+ * initAccl: returns false if a set-up write could not be
+ * queued, in which case the ADXL345 is left unstarted.
  *********************************************************/
-void
+bool
 initAccl (void)
 {
-    char    toAccl[] = {0, 0};  // parameter, value
+    bool queued;
+    uint8_t i;
 
     /*
      * Enable I2C Peripheral
@@ -122,62 +199,379 @@ initAccl (void)
      * Setup I2C
      */
     I2CMasterInitExpClk(I2C0_BASE, SysCtlClockGet(), true);
+    initI2CQueue ();
+
+    /*
+     * Timestamp timer: a 32-bit down counter, reloading every
+     * 2^32 cycles (215 s at 20 MHz). It runs on in deep sleep,
+     * from the 16 MHz PIOSC, so time there reads 20% short.
+     */
+    SysCtlPeripheralEnable(ACCL_TIME_PERIPH);
+    TimerConfigure(ACCL_TIME_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(ACCL_TIME_BASE, TIMER_A, 0xFFFFFFFF);
+    TimerEnable(ACCL_TIME_BASE, TIMER_A);
+    sample_period = SysCtlClockGet() / ACCL_SAMPLE_RATE_HZ;
+    have_last = false;
+    accl_missed = 0;
 
+    /*
+     * INT2 (FIFO watermark or DATA_READY) interrupts on the rising edge
+     */
     GPIOPinTypeGPIOInput(ACCL_INT2Port, ACCL_INT2);
+    GPIOIntTypeSet(ACCL_INT2Port, ACCL_INT2, GPIO_RISING_EDGE);
+    GPIOIntClear(ACCL_INT2Port, ACCL_INT2);
+    GPIOIntEnable(ACCL_INT2Port, ACCL_INT2);
+    IntEnable(INT_GPIOE);
+
+    //Initialize ADXL345 Acceleromter. The writes are queued and go out on
+    //the bus in order once interrupts are enabled. Zero-g offsets from the
+    //last calibration go first (0 if none, see acclCal.h); measuring is
+    //only started if every write before it was queued.
+    queued = acclCalWriteOffsets();
+    for (i = 0; queued && i < ACCL_SETUP_WRITES; i++)
+        queued = writeI2CReg(ACCL_ADDR, accl_setup[i].reg, accl_setup[i].value);
+
+#if !ACCL_DATA_READY_MODE && ACCL_POWER_SAVE
+    // INT2 must still wake the MCU from deep sleep.
+    SysCtlPeripheralDeepSleepEnable(SYSCTL_PERIPH_GPIOE);
+    SysCtlPeripheralDeepSleepEnable(ACCL_TIME_PERIPH);
+#endif
+    return queued;
+}
 
-    //Initialize ADXL345 Acceleromter
+/********************************************************
+ * Timestamp timer, counting up from 0
+ ********************************************************/
+static uint32_t
+acclTime (void)
+{
+    return ~TimerValueGet(ACCL_TIME_BASE, TIMER_A);
+}
+
+#if ACCL_DATA_READY_MODE
+static bool startSampleRead (bool from_edge);
+#endif
 
-    // set +-2g, 13 bit resolution, active low interrupts
-    toAccl[0] = ACCL_DATA_FORMAT;
-    toAccl[1] = (ACCL_RANGE_2G | ACCL_FULL_RES);
-    I2CGenTransmit(toAccl, 1, WRITE, ACCL_ADDR);
+/********************************************************
+ * GPIO port E interrupt handler: ADXL345 INT2, and the UP
+ * button on PE0
+ ********************************************************/
+void
+GPIOPortEIntHandler (void)
+{
+    uint32_t status = GPIOIntStatus(ACCL_INT2Port, true);
+
+    GPIOIntClear(ACCL_INT2Port, status);
+    buttonEdgeInt(ACCL_INT2Port, status);
+    if (status & ACCL_INT2)
+    {
+#if ACCL_DATA_READY_MODE
+        ready_time = acclTime(); //Timestamped at the edge, read at once
+        startSampleRead (true);
+#else
+        fifo_int = true;
+        schedNotify ();
+#endif
+    }
+}
+
+/********************************************************
+ * Returns true if the FIFO has reached its watermark, or
+ * in ACCL_DATA_READY_MODE if a sample is waiting that the
+ * GPIO port E handler could not start reading. The INT2
+ * level is checked as well as the interrupt flag, so an
+ * edge that arrived mid-drain is not lost.
+ ********************************************************/
+bool
+acclFifoReady (void)
+{
+    bool ready = fifo_int;
+
+    fifo_int = false;
+    return ready || GPIOPinRead(ACCL_INT2Port, ACCL_INT2) != 0;
+}
+
+/********************************************************
+ * FIFO drain callbacks, run in the I2C0 ISR. One 6-byte
+ * read pops one sample. Each read is made into a claimed
+ * accl_queue slot, so the I2C0 ISR stores every byte in
+ * its final place; the completion only commits the slot
+ * and queues the next read. If the queue is full, the
+ * sample is still read (to pop it) and then dropped.
+ *
+ * Each slot's timestamp is worked back from drain_time at
+ * one sample_period per sample still to come. Missed
+ * samples are counted from gaps between the timestamps.
+ * In FIFO mode drain_time is taken when FIFO_STATUS is
+ * read, up to a sample_period after the newest sample
+ * converted, so a gap is only trusted once the ADXL345's
+ * OVERRUN flag says samples were overwritten, and then
+ * counts at least one. Timer1 runs slow in deep sleep, so
+ * a gap spanning one is an underestimate.
+ ********************************************************/
+static void fifoReadDone (void *arg, bool ok);
+
+static bool
+submitFifoRead (void)
+{
+    i2cTransaction_t t;
+
+    t.addr = ACCL_ADDR;
+    t.reg = ACCL_DATA_X0;
+    t.read = READ;
+    fifo_slot = spscClaim (&accl_queue);
+    t.len = sizeof(vector3_t);
+    t.data = (uint8_t *) ((fifo_slot != NULL) ? fifo_slot : &fifo_discard);
+    t.callback = fifoReadDone;
+    t.arg = NULL;
+    return submitI2C (&t);
+}
+
+static void
+finishDrain (void)
+{
+    fifo_busy = false;
+    if (fifo_count > 0)
+        schedNotify ();
+#if ACCL_DATA_READY_MODE
+    if (read_again)
+        startSampleRead (false);
+#endif
+}
+
+static uint32_t
+samplesSkipped (uint32_t time)
+{
+    uint32_t gap = time - last_time;
+
+    if (!have_last || gap <= sample_period + sample_period / 2)
+        return 0;
+    return (gap + sample_period / 2) / sample_period - 1;
+}
+
+static void
+fifoReadDone (void *arg, bool ok)
+{
+    uint32_t time;
+#if !ACCL_DATA_READY_MODE
+    uint32_t skipped;
+#endif
 
-    toAccl[0] = ACCL_PWR_CTL;
-    toAccl[1] = ACCL_MEASURE;
-    I2CGenTransmit(toAccl, 1, WRITE, ACCL_ADDR);
+    if (ok)
+    {
+        time = drain_time - (uint32_t) (fifo_entries - 1 - fifo_count) * sample_period;
+#if ACCL_DATA_READY_MODE
+        accl_missed += samplesSkipped (time);
+#else
+        if (fifo_overrun)
+        {
+            skipped = samplesSkipped (time);
+            accl_missed += (skipped > 0) ? skipped : 1;
+            fifo_overrun = false;
+        }
+#endif
+        last_time = time;
+        have_last = true;
+        if (fifo_slot != NULL)
+        {
+            accl_times[fifo_slot - accl_queue_data] = time;
+#ifdef ACCL_SWAP_IN_PLACE
+            fifo_slot->x = (uint16_t) fifo_slot->x >> 8 | fifo_slot->x << 8;
+            fifo_slot->y = (uint16_t) fifo_slot->y >> 8 | fifo_slot->y << 8;
+            fifo_slot->z = (uint16_t) fifo_slot->z >> 8 | fifo_slot->z << 8;
+#endif
+            spscCommit (&accl_queue);
+        }
+        fifo_count++;
+    }
+    if (!ok || fifo_count == fifo_entries || !submitFifoRead ())
+        finishDrain ();
+}
 
+#if !ACCL_DATA_READY_MODE
+static void
+fifoStatusDone (void *arg, bool ok)
+{
+    drain_time = acclTime();
+    fifo_entries = fifo_status & ACCL_FIFO_ENTRIES;
+    if (fifo_entries > ACCL_FIFO_BATCH)
+        fifo_entries = ACCL_FIFO_BATCH;
+    fifo_count = 0;
+
+    if (!ok || fifo_entries == 0 || !submitFifoRead ())
+        finishDrain ();
+}
 
-    toAccl[0] = ACCL_BW_RATE;
-    toAccl[1] = ACCL_RATE_100HZ;
-    I2CGenTransmit(toAccl, 1, WRITE, ACCL_ADDR);
+static void
+intSourceDone (void *arg, bool ok)
+{
+    i2cTransaction_t t;
+
+    if (ok && (int_source & ACCL_INT_ACTIVITY))
+        accl_active = true;
+    else if (ok && (int_source & ACCL_INT_INACTIVITY))
+        accl_active = false;
+    fifo_overrun = ok && (int_source & ACCL_INT_OVERRUN);
+
+    t.addr = ACCL_ADDR;
+    t.reg = ACCL_FIFO_STATUS;
+    t.read = READ;
+    t.len = 1;
+    t.data = &fifo_status;
+    t.callback = fifoStatusDone;
+    t.arg = NULL;
+    if (!submitI2C (&t))
+        finishDrain ();
+}
+#endif
 
-    toAccl[0] = ACCL_INT;
-    toAccl[1] = 0x00;       // Disable interrupts from accelerometer.
-    I2CGenTransmit(toAccl, 1, WRITE, ACCL_ADDR);
+#if ACCL_DATA_READY_MODE
+/********************************************************
+ * startSampleRead: ACCL_DATA_READY_MODE drain of the one
+ * sample in the data registers, stamped with the last
+ * DATA_READY edge. If a read is already running, an edge
+ * (from_edge) means a new sample, read once that one ends.
+ * If the I2C queue is full, main() retries through
+ * acclFifoReady(). Returns true if the read was queued.
+ ********************************************************/
+static bool
+startSampleRead (bool from_edge)
+{
+    bool was_masked = IntMasterDisable ();
+    bool started = false;
 
-    toAccl[0] = ACCL_OFFSET_X;
-    toAccl[1] = 0x00;
-    I2CGenTransmit(toAccl, 1, WRITE, ACCL_ADDR);
+    if (fifo_busy)
+        read_again = read_again || from_edge;
+    else
+    {
+        read_again = false;
+        fifo_busy = true;
+        fifo_entries = 1;
+        fifo_count = 0;
+        drain_time = ready_time;
+        started = submitFifoRead ();
+        if (!started)
+        {
+            fifo_busy = false;
+            fifo_int = true;
+            schedNotify ();
+        }
+    }
+    if (!was_masked)
+        IntMasterEnable ();
+    return started;
+}
+#endif
 
-    toAccl[0] = ACCL_OFFSET_Y;
-    toAccl[1] = 0x00;
-    I2CGenTransmit(toAccl, 1, WRITE, ACCL_ADDR);
+/********************************************************
+ * Function to start pulling every sample held by the FIFO
+ * (up to ACCL_FIFO_BATCH) in one batch, or in
+ * ACCL_DATA_READY_MODE the one waiting sample. Returns
+ * false if a drain is already running or the I2C queue is
+ * full.
+ ********************************************************/
+bool
+drainAcclFifo (void)
+{
+#if ACCL_DATA_READY_MODE
+    return startSampleRead (false);
+#else
+    i2cTransaction_t t;
+
+    if (fifo_busy)
+        return false;
+
+    // INT_SOURCE first: reading it clears the activity and inactivity
+    // events, which share INT2 with the watermark.
+    t.addr = ACCL_ADDR;
+    t.reg = ACCL_INT_SOURCE;
+    t.read = READ;
+    t.len = 1;
+    t.data = &int_source;
+    t.callback = intSourceDone;
+    t.arg = NULL;
+
+    fifo_busy = true;
+    if (!submitI2C (&t))
+    {
+        fifo_busy = false;
+        return false;
+    }
+    return true;
+#endif
+}
 
-    toAccl[0] = ACCL_OFFSET_Z;
-    toAccl[1] = 0x00;
-    I2CGenTransmit(toAccl, 1, WRITE, ACCL_ADDR);
+/********************************************************
+ * Takes up to max drained samples off the queue, oldest
+ * first, without stopping interrupts. Samples arrive as
+ * each read completes, so a drain still in progress may
+ * already have some. Returns the number taken, 0 if none.
+ ********************************************************/
+uint8_t
+getAcclBatch (vector3_t *samples, uint8_t max)
+{
+    return spscPopBatch (&accl_queue, samples, max);
 }
 
 /********************************************************
- * Function to read accelerometer
+ * Zero-copy alternative to getAcclBatch: points *samples
+ * at drained samples where the I2C0 ISR read them, and
+ * returns how many (0 if none). They must be released
+ * with releaseAcclSamples once used.
  ********************************************************/
-vector3_t
-getAcclData (void)
+uint8_t
+peekAcclSamples (const vector3_t **samples)
 {
-    char    fromAccl[] = {0, 0, 0, 0, 0, 0, 0}; // starting address, placeholders for data to be read.
-    vector3_t acceleration;
-    uint8_t bytesToRead = 6;
+    return spscPeek (&accl_queue, samples);
+}
 
-    fromAccl[0] = ACCL_DATA_X0;
-    I2CGenTransmit(fromAccl, bytesToRead, READ, ACCL_ADDR);
+void
+releaseAcclSamples (uint8_t count)
+{
+    spscRelease (&accl_queue, count);
+}
+
+/********************************************************
+ * Timestamps of peeked samples, in timer cycles at the
+ * system clock: pass the pointer peekAcclSamples gave and
+ * index the result the same way. Valid until released.
+ ********************************************************/
+const uint32_t *
+acclSampleTimes (const vector3_t *samples)
+{
+    return &accl_times[samples - accl_queue_data];
+}
 
-    acceleration.x = (fromAccl[2] << 8) | fromAccl[1]; // Return 16-bit acceleration readings.
-    acceleration.y = (fromAccl[4] << 8) | fromAccl[3];
-    acceleration.z = (fromAccl[6] << 8) | fromAccl[5];
+/********************************************************
+ * Conversions the ADXL345 made that were never read, as
+ * worked out from the timestamps (see fifoReadDone)
+ ********************************************************/
+uint32_t
+acclMissedSamples (void)
+{
+    return accl_missed;
+}
 
-    return acceleration;
+/********************************************************
+ * Samples dropped because main() fell ACCL_QUEUE_SIZE
+ * behind the drain
+ ********************************************************/
+uint32_t
+acclQueueOverflows (void)
+{
+    return spscOverflows (&accl_queue);
 }
 
+/********************************************************
+ * Returns false once the ADXL345 has reported inactivity,
+ * until it reports activity again. Always true without
+ * ACCL_POWER_SAVE.
+ ********************************************************/
+bool
+acclIsActive (void)
+{
+    return accl_active;
+}
 
 /********************************************************
  * Function to calculate the mean value
@@ -18,31 +18,68 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include "circBufT.h"
+#include "vector3.h"
 
 /**********************************************************
  * Constants
  **********************************************************/
 // Systick configuration
-#define SYSTICK_RATE_HZ    10
+#define SYSTICK_RATE_HZ    100
+// Accelerometer output rate and FIFO use
+#define ACCL_SAMPLE_RATE_HZ 100
+#define ACCL_FIFO_WATERMARK 16  // Samples held before INT2 is raised
+#define ACCL_FIFO_BATCH     33  // Most samples one drain pulls (FIFO + output registers)
+#define ACCL_QUEUE_SIZE     64  // Drained samples waiting for main(), a power of two
+// Sample capture. 0: the FIFO streams with its watermark on INT2 and is
+// drained in batches. 1: the FIFO is bypassed and DATA_READY is mapped to
+// INT2, so the GPIO port E handler reads each sample as it converts. That
+// wakes the MCU at ACCL_SAMPLE_RATE_HZ, so it leaves auto sleep off.
+#ifndef ACCL_DATA_READY_MODE
+#define ACCL_DATA_READY_MODE 0
+#endif
+// Sample timestamps, in system clock cycles from timer 1 running free
+#define ACCL_TIME_PERIPH    SYSCTL_PERIPH_TIMER1
+#define ACCL_TIME_BASE      TIMER1_BASE
+// Power management: the ADXL345 converts in low-power mode and sleeps
+// (sampling at 8 Hz) after ACCL_INACT_TIME s below ACCL_INACT_THRESH. The
+// MCU then stops SysTick and deep sleeps until INT2 (watermark or activity).
+#define ACCL_POWER_SAVE     1
+#define ACCL_ACT_THRESH     3   // 62.5 mg/LSB, AC coupled: about 0.19 g
+#define ACCL_INACT_THRESH   2   // About 0.13 g
+#define ACCL_INACT_TIME     3   // Seconds
 #define BUFF_SIZE 10
+#define MEAN_WINDOW_MAX 256     // Longest moving average window, in samples
 #define NUM_BITS 256
 #define GRAVITY 9.81
 
-typedef struct vector{
-    int16_t x;
-    int16_t y;
-    int16_t z;
-} vector3_t;
-
 void initClock (void);
 
 void initDisplay (void);
 
-void displayUpdate (char *str1, char *str2, int16_t num, uint8_t charLine);
+void displayUpdate (char *str1, char *str2, int32_t num, uint8_t charLine);
+
+bool initAccl (void);
+
+bool acclFifoReady (void);
+
+bool drainAcclFifo (void);
+
+uint8_t getAcclBatch (vector3_t *samples, uint8_t max);
+
+uint8_t peekAcclSamples (const vector3_t **samples);
+
+void releaseAcclSamples (uint8_t count);
+
+const uint32_t *acclSampleTimes (const vector3_t *samples);
+
+uint32_t acclMissedSamples (void);
+
+uint32_t acclQueueOverflows (void);
 
-void initAccl (void);
+bool acclIsActive (void);
 
-vector3_t getAcclData (void);
+void GPIOPortEIntHandler (void);
 
 int16_t calcMean(int32_t sum, uint16_t i, circBuf_t *buffer);
 
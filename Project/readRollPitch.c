@@ -3,7 +3,8 @@
  * readRollPitch
  *
  * Calculates the reference orientation of the board when the program is
- * first loaded and then displays pitch and roll in radians.
+ * first loaded and then displays pitch and roll in degrees. The angles
+ * come from the integer routines in orientFixed.c.
  * Reference orientation can be reset by holding DOWN.
  *
  *    Ben Stewart and Daniel Pallesen
@@ -14,7 +15,6 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
-#include <math.h> // for sqrt() and pow() functions
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "inc/hw_i2c.h"
@@ -30,6 +30,7 @@
 #include "buttons4.h"
 #include "circBufT.h"
 #include "readAcc.h"
+#include "orientFixed.h"
 
 // CONSTANTS
 
@@ -48,27 +49,19 @@ getSign(int32_t x)
 /********************************************************
  * Function to calculate pitch given an accelerometer values
  ********************************************************/
-int8_t
-calcPitch(vector3_t acceleration, int8_t relative_pitch)
+int16_t
+calcPitch(vector3_t acceleration, int16_t relative_pitch)
 {
-    double x_square = pow(acceleration.x, 2);
-    double z_square =  pow(acceleration.z, 2);
-
-    return (atan2(acceleration.y, sqrt(x_square + z_square))*RAD_TO_DEG) - relative_pitch;
-
+    return centidegToDeg(pitchCentideg(acceleration)) - relative_pitch;
 }
 
 /********************************************************
  * Function to calculate roll given an accelerometer values
  ********************************************************/
-int8_t
-calcRoll(vector3_t acceleration, int8_t relative_roll)
+int16_t
+calcRoll(vector3_t acceleration, int16_t relative_roll)
 {
-    double x_square = pow(acceleration.x, 2);
-    double z_square =  pow(acceleration.z, 2);
-
-    return (atan2(-raw_acceleration.x, raw_acceleration.z)*RAD_TO_DEG) - relative_roll;
-
+    return centidegToDeg(rollCentideg(acceleration)) - relative_roll;
 }
 
 
@@ -16,9 +16,11 @@
 
 int8_t getSign (int32_t x);
 
-int8_t calcPitch(vector3_t acceleration, int8_t relative_pitch);
+// Whole degrees, rounded. Roll spans -180..180, so the results
+// and relative angles are int16_t.
+int16_t calcPitch(vector3_t acceleration, int16_t relative_pitch);
 
-int8_t calcRoll(vector3_t acceleration, int8_t relative_roll);
+int16_t calcRoll(vector3_t acceleration, int16_t relative_roll);
 
 
 #endif /* READROLLPITCH_H_ */
@@ -0,0 +1,37 @@
+/**********************************************************
+ *
+ * rtc.c
+ *
+ * Hibernation module RTC, see rtc.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    9th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib/sysctl.h"
+#include "driverlib/hibernate.h"
+#include "rtc.h"
+
+/*********************************************************
+ * initRtc
+ *********************************************************/
+void
+initRtc (void)
+{
+    SysCtlPeripheralEnable (SYSCTL_PERIPH_HIBERNATE);
+    HibernateEnableExpClk (SysCtlClockGet ());
+    HibernateClockConfig (HIBERNATE_OSC_LOWDRIVE);  // 32.768 kHz crystal on XOSC0
+    HibernateRTCEnable ();
+}
+
+/*********************************************************
+ * rtcSeconds
+ *********************************************************/
+uint32_t
+rtcSeconds (void)
+{
+    return HibernateRTCGet ();
+}
@@ -0,0 +1,33 @@
+#ifndef RTC_H_
+#define RTC_H_
+
+/**********************************************************
+ *
+ * rtc.h
+ *
+ * Seconds clock from the hibernation module's RTC, run off
+ * the 32.768 kHz crystal. Unlike SysTick it keeps counting
+ * in deep sleep, and unlike the timers it is not slowed by
+ * the PIOSC there, so it times the step log across idle
+ * periods.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    9th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+
+// *******************************************************
+// initRtc: Starts the hibernation module's oscillator and
+// RTC. Call after initClock().
+void
+initRtc (void);
+
+// *******************************************************
+// rtcSeconds: Seconds counted by the RTC. Only differences
+// are meaningful, it is not set to the time of day.
+uint32_t
+rtcSeconds (void);
+
+#endif /* RTC_H_ */
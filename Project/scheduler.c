@@ -0,0 +1,297 @@
+/**********************************************************
+ *
+ * scheduler.c
+ *
+ * Cooperative run-to-completion task scheduler, see
+ * scheduler.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/systick.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/interrupt.h"
+#include "utils/ustdlib.h"
+#include "readAcc.h"
+#include "i2cQueue.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "scheduler.h"
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static schedTask_t sched_tasks[NUM_SCHED_TASKS];
+static uint16_t sched_divider[NUM_SCHED_TASKS];         // 0 if not periodic
+static uint16_t sched_deadline[NUM_SCHED_TASKS];        // In SysTick periods
+static schedStats_t sched_stats[NUM_SCHED_TASKS];
+
+static volatile bool sched_due[NUM_SCHED_TASKS];        // Set by SysTick
+static volatile bool sched_pending[NUM_SCHED_TASKS];    // Waiting to run
+static volatile uint32_t sched_release[NUM_SCHED_TASKS];
+static bool sched_enabled[NUM_SCHED_TASKS];
+static volatile uint32_t sched_ticks;
+static volatile bool sched_event;
+static bool sched_idle;
+
+static const char *const task_names[NUM_SCHED_TASKS] = {
+    "sample", "step", "buttons", "display", "telemetry", "log"
+};
+
+/*********************************************************
+ * SysTick interrupt handler: releases the periodic tasks.
+ *********************************************************/
+void
+SysTickIntHandler (void)
+{
+    uint8_t task;
+
+    sched_ticks++;
+    for (task = 0; task < NUM_SCHED_TASKS; task++)
+    {
+        if (sched_enabled[task] && sched_divider[task] != 0
+            && sched_ticks % sched_divider[task] == 0)
+        {
+            if (sched_due[task] || sched_pending[task])
+                sched_stats[task].skipped++;    // Previous release still waiting
+            else
+            {
+                sched_release[task] = sched_ticks;
+                sched_due[task] = true;
+            }
+        }
+    }
+}
+
+/*********************************************************
+ * schedAddTask
+ *********************************************************/
+void
+schedAddTask (uint8_t task, const schedTask_t *config)
+{
+    sched_tasks[task] = *config;
+    sched_divider[task] = config->rate_hz ? SYSTICK_RATE_HZ / config->rate_hz : 0;
+    sched_deadline[task] = (uint32_t) config->deadline_ms * SYSTICK_RATE_HZ / 1000;
+    sched_enabled[task] = true;
+}
+
+/*********************************************************
+ * initScheduler
+ *********************************************************/
+void
+initScheduler (void)
+{
+    uint8_t task;
+
+    for (task = 0; task < NUM_SCHED_TASKS; task++)
+    {
+        sched_due[task] = false;
+        sched_pending[task] = false;
+        sched_stats[task].runs = 0;
+        sched_stats[task].max_us = 0;
+        sched_stats[task].over_budget = 0;
+        sched_stats[task].missed = 0;
+        sched_stats[task].skipped = 0;
+    }
+    sched_ticks = 0;
+    sched_idle = false;
+
+    initProfileClock (); //Run times are read from profileNow()
+
+    // Deep sleep runs from the 16 MHz PIOSC with the PLL off and only the
+    // peripherals enabled for it clocked; the run clock returns on wake-up.
+    SysCtlDeepSleepClockSet (SYSCTL_DSLP_DIV_1 | SYSCTL_DSLP_OSC_INT);
+    SysCtlPeripheralClockGating (true);
+
+    SysTickPeriodSet (SysCtlClockGet () / SYSTICK_RATE_HZ);
+    SysTickIntEnable ();
+    SysTickEnable ();
+    IntMasterEnable ();
+}
+
+/*********************************************************
+ * schedPoll: Marks pending the tasks released since the
+ * last poll, leaving out those that have already run in
+ * this schedRun(). Pending is set before due is cleared,
+ * so SysTick always sees one of them while the release is
+ * waiting.
+ *********************************************************/
+static void
+schedPoll (const bool *ran)
+{
+    uint8_t task;
+
+    for (task = 0; task < NUM_SCHED_TASKS; task++)
+    {
+        if (ran[task] || sched_pending[task])
+            continue;
+        if (sched_due[task])
+        {
+            sched_pending[task] = true;
+            sched_due[task] = false;
+        }
+        else if (sched_tasks[task].ready != NULL && sched_tasks[task].ready ())
+        {
+            sched_release[task] = sched_ticks;
+            sched_pending[task] = true;
+        }
+    }
+}
+
+/*********************************************************
+ * schedRun: each task runs at most once per call, so one
+ * whose ready test stays true while it waits on hardware
+ * (a FIFO drain in progress) cannot spin here; the
+ * interrupt that ends the wait calls schedNotify().
+ *********************************************************/
+void
+schedRun (void)
+{
+    bool ran[NUM_SCHED_TASKS];
+    uint8_t task;
+    uint8_t next;
+    uint32_t start;
+    uint32_t run_us;
+    schedStats_t *stats;
+
+    for (task = 0; task < NUM_SCHED_TASKS; task++)
+        ran[task] = false;
+
+    while (1)
+    {
+        schedPoll (ran);
+        next = NUM_SCHED_TASKS;
+        for (task = 0; task < NUM_SCHED_TASKS; task++)
+            if (sched_pending[task] && (next == NUM_SCHED_TASKS
+                || sched_tasks[task].priority < sched_tasks[next].priority))
+                next = task;
+        if (next == NUM_SCHED_TASKS)
+            return;
+
+        sched_pending[next] = false;
+        ran[next] = true;
+        start = profileNow ();
+        sched_tasks[next].run ();
+        run_us = (profileNow () - start) / profileTicksPerUs ();
+
+        stats = &sched_stats[next];
+        stats->runs++;
+        if (run_us > stats->max_us)
+            stats->max_us = run_us;
+        if (run_us > sched_tasks[next].budget_us)
+            stats->over_budget++;
+        if (sched_ticks - sched_release[next] > sched_deadline[next])
+            stats->missed++;
+    }
+}
+
+void
+schedEnable (uint8_t task, bool enable)
+{
+    sched_enabled[task] = enable;
+    if (!enable)
+        sched_due[task] = false;
+}
+
+void
+schedSetIdle (bool idle)
+{
+    if (idle == sched_idle)
+        return;
+    sched_idle = idle;
+    if (idle)
+        SysTickDisable ();
+    else
+        SysTickEnable ();
+}
+
+/*********************************************************
+ * schedWait: interrupts are masked while the flags are
+ * checked. WFI still wakes on a pending interrupt with
+ * PRIMASK set, and the handler runs once they are unmasked.
+ * Handlers that leave no work for main() (most I2C byte
+ * interrupts) send the CPU straight back to sleep here.
+ * Deep sleep is skipped while I2C or the telemetry UART is
+ * busy, as it would slow their clocks mid-transfer.
+ *********************************************************/
+static bool
+schedPending (void)
+{
+    uint8_t task;
+
+    for (task = 0; task < NUM_SCHED_TASKS; task++)
+        if (sched_due[task])
+            return true;
+    return sched_event;
+}
+
+void
+schedWait (void)
+{
+    IntMasterDisable ();
+    while (!schedPending ())
+    {
+        if (sched_idle && isI2CIdle () && telemetryIdle ())
+            SysCtlDeepSleep ();
+        else
+            SysCtlSleep ();
+        IntMasterEnable ();     // The waking handler runs here
+        IntMasterDisable ();
+    }
+    sched_event = false;
+    IntMasterEnable ();
+}
+
+void
+schedNotify (void)
+{
+    sched_event = true;
+}
+
+void
+schedGetStats (uint8_t task, schedStats_t *stats)
+{
+    *stats = sched_stats[task];
+}
+
+void
+schedDump (schedPrint_t print)
+{
+    char line[80];
+    uint8_t task;
+    const schedStats_t *s;
+
+    print ("scheduler, times in us");
+    usnprintf (line, sizeof (line), "  %10s %4s %6s %8s %6s %6s %6s %6s",
+               "task", "prio", "budget", "runs", "max", "over", "missed",
+               "skip");
+    print (line);
+    for (task = 0; task < NUM_SCHED_TASKS; task++)
+    {
+        s = &sched_stats[task];
+        usnprintf (line, sizeof (line), "  %10s %4u %6u %8u %6u %6u %6u %6u",
+                   task_names[task], (unsigned) sched_tasks[task].priority,
+                   (unsigned) sched_tasks[task].budget_us, (unsigned) s->runs,
+                   (unsigned) s->max_us, (unsigned) s->over_budget,
+                   (unsigned) s->missed, (unsigned) s->skipped);
+        print (line);
+    }
+}
+
+uint32_t
+schedTicks (void)
+{
+    return sched_ticks;
+}
+
+uint32_t
+schedMillis (void)
+{
+    return sched_ticks * (1000 / SYSTICK_RATE_HZ);
+}
@@ -0,0 +1,149 @@
+/**********************************************************
+ *
+ * scheduler.h
+ *
+ * Cooperative run-to-completion task scheduler. Each task
+ * is released by SysTick at a fixed rate, by a ready test
+ * polled between tasks, or both. schedRun() runs released
+ * tasks one at a time, most urgent priority first, and
+ * checks again for releases after each one, so a slow task
+ * delays sampling by at most its own run time. main() then
+ * sleeps in schedWait() until the next interrupt.
+ *
+ * Every run is timed against the task's budget, and its
+ * completion against its deadline (in SysTick periods from
+ * release). A periodic release that finds the previous one
+ * still waiting is skipped. All three are counted per task,
+ * see schedGetStats() and schedDump().
+ *
+ * In idle mode SysTick is stopped and the MCU deep sleeps
+ * (whenever the I2C queue is empty) until some other
+ * interrupt arrives, so no periodic task comes due and no
+ * deadline passes until the scheduler is woken back up.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of April 2022
+ *
+ **********************************************************/
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+// Task rates, each must divide SYSTICK_RATE_HZ (readAcc.h). Sampling is
+// paced by the accelerometer itself, see ACCL_SAMPLE_RATE_HZ. Button
+// edges arrive by interrupt, see buttonsChanged(); the button task only
+// times gestures and is enabled only while one is in progress.
+#define BUTTON_RATE_HZ      50
+#define DISPLAY_RATE_HZ     4
+#define LOG_RATE_HZ         1
+
+// Tasks, see main.c for what each does and its budget.
+enum schedTasks {SCHED_SAMPLE = 0,  // Starts a FIFO drain
+                 SCHED_STEP,        // Filters and step detector, per sample
+                 SCHED_BUTTONS,     // Button gestures
+                 SCHED_DISPLAY,     // Pitch, roll and steps to the OLED
+                 SCHED_TELEMETRY,   // Sends the queued telemetry frames
+                 SCHED_LOG,         // New steps to the flash log
+                 NUM_SCHED_TASKS};
+
+typedef void (*schedRun_t) (void);
+typedef bool (*schedReady_t) (void);
+typedef void (*schedPrint_t) (const char *line);
+
+typedef struct {
+    schedRun_t run;
+    schedReady_t ready;     // Polled between tasks, NULL if only periodic
+    uint16_t rate_hz;       // 0 if released only by ready
+    uint16_t deadline_ms;   // From release to completion
+    uint16_t budget_us;     // Longest run expected
+    uint8_t priority;       // 0 is the most urgent
+} schedTask_t;
+
+typedef struct {
+    uint32_t runs;
+    uint32_t max_us;        // Longest run
+    uint32_t over_budget;   // Runs longer than budget_us
+    uint32_t missed;        // Runs completed after their deadline
+    uint32_t skipped;       // Periodic releases lost to a waiting one
+} schedStats_t;
+
+// *******************************************************
+// schedAddTask: Installs a task, enabled. Call for every
+// task before initScheduler().
+void
+schedAddTask (uint8_t task, const schedTask_t *config);
+
+// *******************************************************
+// initScheduler: Configures SysTick for SYSTICK_RATE_HZ and
+// enables its interrupt. Call after initClock().
+void
+initScheduler (void);
+
+// *******************************************************
+// schedRun: Runs each released task once, most urgent
+// first, until none is left. A task released again after
+// it has run waits for the next call.
+void
+schedRun (void);
+
+// *******************************************************
+// schedEnable: Enables or disables a task's periodic
+// releases. Its ready test is polled either way.
+void
+schedEnable (uint8_t task, bool enable);
+
+// *******************************************************
+// schedWait: Sleeps until an interrupt arrives, unless a
+// periodic task is already due or schedNotify() has been
+// called since the last wait. Free of the race between
+// checking the flags and sleeping.
+void
+schedWait (void);
+
+// *******************************************************
+// schedSetIdle: Enters (true) or leaves (false) idle mode.
+void
+schedSetIdle (bool idle);
+
+// *******************************************************
+// schedNotify: Called from an interrupt that has left work
+// for main(), so the next schedWait() returns at once.
+void
+schedNotify (void);
+
+// *******************************************************
+// schedGetStats: Copies out a task's run counters.
+void
+schedGetStats (uint8_t task, schedStats_t *stats);
+
+// *******************************************************
+// schedDump: Prints a line per task of its counters,
+// through print.
+void
+schedDump (schedPrint_t print);
+
+// *******************************************************
+// schedTicks: SysTick periods since initScheduler().
+uint32_t
+schedTicks (void);
+
+// *******************************************************
+// schedMillis: Milliseconds of SysTick time since
+// initScheduler(), in steps of one tick. The count stands
+// still in idle mode.
+uint32_t
+schedMillis (void);
+
+// *******************************************************
+// SysTickIntHandler: SysTick interrupt handler, installed
+// in the vector table in tm4c123gh6pm_startup_ccs.c.
+void
+SysTickIntHandler (void);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,111 @@
+/**********************************************************
+ *
+ * spscQueue.c
+ *
+ * Lock-free single producer, single consumer sample queue,
+ * see spscQueue.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    28th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "spscQueue.h"
+
+bool
+spscPush (spscQueue_t *queue, const vector3_t *sample)
+{
+    return spscPushBatch (queue, sample, 1) == 1;
+}
+
+uint16_t
+spscPushBatch (spscQueue_t *queue, const vector3_t *samples, uint16_t count)
+{
+    uint16_t head = queue->head;
+    uint16_t space = queue->mask + 1 - (uint16_t) (head - queue->tail);
+    uint16_t i;
+
+    SPSC_ACQUIRE ();        // Consumer has finished with the slots it freed
+    if (count > space)
+    {
+        queue->overflows += count - space;
+        count = space;
+    }
+    for (i = 0; i < count; i++)
+        queue->data[(uint16_t) (head + i) & queue->mask] = samples[i];
+    SPSC_RELEASE ();        // Samples are in place before head moves
+    queue->head = head + count;
+    return count;
+}
+
+uint16_t
+spscPopBatch (spscQueue_t *queue, vector3_t *samples, uint16_t max)
+{
+    uint16_t tail = queue->tail;
+    uint16_t count = (uint16_t) (queue->head - tail);
+    uint16_t i;
+
+    SPSC_ACQUIRE ();        // Samples up to head are visible
+    if (count > max)
+        count = max;
+    for (i = 0; i < count; i++)
+        samples[i] = queue->data[(uint16_t) (tail + i) & queue->mask];
+    SPSC_RELEASE ();        // Slots are read before tail frees them
+    queue->tail = tail + count;
+    return count;
+}
+
+vector3_t *
+spscClaim (spscQueue_t *queue)
+{
+    uint16_t head = queue->head;
+
+    if ((uint16_t) (head - queue->tail) > queue->mask)
+    {
+        queue->overflows++;
+        return NULL;
+    }
+    SPSC_ACQUIRE ();        // Consumer has finished with the slot it freed
+    return &queue->data[head & queue->mask];
+}
+
+void
+spscCommit (spscQueue_t *queue)
+{
+    SPSC_RELEASE ();        // Slot is filled before head moves
+    queue->head++;
+}
+
+uint16_t
+spscPeek (spscQueue_t *queue, const vector3_t **samples)
+{
+    uint16_t tail = queue->tail;
+    uint16_t count = (uint16_t) (queue->head - tail);
+    uint16_t to_wrap = queue->mask + 1 - (tail & queue->mask);
+
+    SPSC_ACQUIRE ();        // Samples up to head are visible
+    *samples = &queue->data[tail & queue->mask];
+    return (count < to_wrap) ? count : to_wrap;
+}
+
+void
+spscRelease (spscQueue_t *queue, uint16_t count)
+{
+    SPSC_RELEASE ();        // Slots are read before tail frees them
+    queue->tail += count;
+}
+
+uint16_t
+spscCount (const spscQueue_t *queue)
+{
+    return (uint16_t) (queue->head - queue->tail);
+}
+
+uint32_t
+spscOverflows (const spscQueue_t *queue)
+{
+    return queue->overflows;
+}
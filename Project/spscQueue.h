@@ -0,0 +1,130 @@
+#ifndef SPSCQUEUE_H_
+#define SPSCQUEUE_H_
+
+/**********************************************************
+ *
+ * spscQueue.h
+ *
+ * Lock-free single producer, single consumer queue of
+ * vector3_t samples. Meant for an interrupt handler that
+ * produces samples and main() that consumes them, with no
+ * need to disable interrupts.
+ *
+ * Each index has a single writer. The producer owns head
+ * and the consumer owns tail. Both run freely and are
+ * masked on use, so the size must be a power of two. An
+ * index is published with a release barrier after the data
+ * it covers, and read with an acquire barrier before that
+ * data is touched. On the Cortex-M4 the barrier is a DMB.
+ * It also stops the compiler moving accesses across it.
+ *
+ * When the queue is full, new samples are dropped and
+ * counted, so the consumer never sees a torn batch.
+ *
+ * Samples can also be used in place, with no copies. The
+ * producer claims the next slot, fills it (for example an
+ * I2C read lands in it byte by byte), then commits it. The
+ * consumer peeks at the waiting slots, works on them where
+ * they are, then releases them.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    28th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vector3.h"
+
+/**********************************************************
+ * Memory barriers
+ **********************************************************/
+#if defined(HOST_BUILD)
+#define SPSC_ACQUIRE()  __atomic_thread_fence (__ATOMIC_ACQUIRE)
+#define SPSC_RELEASE()  __atomic_thread_fence (__ATOMIC_RELEASE)
+#elif defined(__TI_ARM__) || defined(__TMS470__)
+#define SPSC_ACQUIRE()  __asm("    dmb")
+#define SPSC_RELEASE()  __asm("    dmb")
+#else
+#define SPSC_ACQUIRE()  __asm volatile ("dmb" ::: "memory")
+#define SPSC_RELEASE()  __asm volatile ("dmb" ::: "memory")
+#endif
+
+// *******************************************************
+// Queue structure
+typedef struct {
+    volatile uint16_t head;         // Next slot to fill, producer only
+    volatile uint16_t tail;         // Next slot to empty, consumer only
+    uint16_t mask;                  // Number of slots - 1
+    volatile uint32_t overflows;    // Samples dropped while full, producer only
+    vector3_t *data;
+} spscQueue_t;
+
+// *******************************************************
+// SPSC_DECLARE: Defines an empty spscQueue_t called name
+// with static storage for size samples. size must be a
+// power of two, from 1 to 32768; any other size fails to
+// compile. Use at file scope.
+#define SPSC_DECLARE(name, size) \
+    typedef char name##_size_check[(size) > 0 && (size) <= 32768 \
+                                   && ((size) & ((size) - 1)) == 0 ? 1 : -1]; \
+    static vector3_t name##_data[size]; \
+    static spscQueue_t name = {0, 0, (size) - 1, 0, name##_data}
+
+// *******************************************************
+// spscPush: Producer side. Adds one sample; returns false
+// (and counts an overflow) if the queue is full.
+bool
+spscPush (spscQueue_t *queue, const vector3_t *sample);
+
+// *******************************************************
+// spscPushBatch: Producer side. Adds up to count samples in
+// order and publishes them together. Those that do not fit
+// are dropped and counted. Returns the number added.
+uint16_t
+spscPushBatch (spscQueue_t *queue, const vector3_t *samples, uint16_t count);
+
+// *******************************************************
+// spscPopBatch: Consumer side. Removes up to max samples,
+// oldest first. Returns the number removed.
+uint16_t
+spscPopBatch (spscQueue_t *queue, vector3_t *samples, uint16_t max);
+
+// *******************************************************
+// spscClaim: Producer side. Returns the next free slot to
+// fill in place, or NULL (counting an overflow) if the
+// queue is full. Until spscCommit() it is not published,
+// and claiming again returns the same slot.
+vector3_t *
+spscClaim (spscQueue_t *queue);
+
+// *******************************************************
+// spscCommit: Producer side. Publishes the claimed slot.
+void
+spscCommit (spscQueue_t *queue);
+
+// *******************************************************
+// spscPeek: Consumer side. Points *samples at the oldest
+// waiting samples, in place, and returns how many follow
+// on in storage (stopping at the wrap). They stay queued
+// until spscRelease().
+uint16_t
+spscPeek (spscQueue_t *queue, const vector3_t **samples);
+
+// *******************************************************
+// spscRelease: Consumer side. Frees count peeked samples.
+void
+spscRelease (spscQueue_t *queue, uint16_t count);
+
+// *******************************************************
+// spscCount: Samples waiting. Exact from the consumer; from
+// the producer it may be stale by samples just popped.
+uint16_t
+spscCount (const spscQueue_t *queue);
+
+// *******************************************************
+// spscOverflows: Samples dropped because the queue was full.
+uint32_t
+spscOverflows (const spscQueue_t *queue);
+
+#endif /* SPSCQUEUE_H_ */
@@ -0,0 +1,84 @@
+/**********************************************************
+ *
+ * stepDetect.c
+ *
+ * Streaming step detector, see stepDetect.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    25th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "orientFixed.h"
+#include "stepDetect.h"
+
+void
+initStepDetect (stepDetect_t *detector)
+{
+    detector->lowpass = 0;
+    detector->dc = 0;
+    detector->band = 0;
+    detector->prev_band = 0;
+    detector->peak_avg = 0;
+    detector->since_step = STEP_REFRACTORY;
+    detector->steps = 0;
+    detector->primed = false;
+}
+
+int16_t
+getStepThreshold (const stepDetect_t *detector)
+{
+    int16_t threshold = detector->peak_avg / 2;
+
+    return (threshold < STEP_MIN_THRESHOLD) ? STEP_MIN_THRESHOLD : threshold;
+}
+
+bool
+updateStepDetect (stepDetect_t *detector, vector3_t sample)
+{
+    int32_t in = (int32_t) (magnitudeSq (sample) >> STEP_MAG_SHIFT)
+                 << STEP_FRAC_BITS;
+    int16_t before = detector->prev_band;
+    int16_t peak = detector->band;
+    bool step = false;
+
+    if (!detector->primed)
+    {
+        // Start the filters at the first reading instead of ramping up from 0.
+        detector->lowpass = in;
+        detector->dc = in;
+        detector->primed = true;
+    }
+    detector->lowpass += (in - detector->lowpass) >> STEP_LP_SHIFT;
+    detector->dc += (in - detector->dc) >> STEP_DC_SHIFT;
+
+    detector->prev_band = peak;
+    detector->band = (detector->lowpass - detector->dc) >> STEP_FRAC_BITS;
+
+    if (detector->since_step < UINT16_MAX)
+        detector->since_step++;
+
+    // The previous output is a peak if it is above both of its neighbours.
+    if (peak > detector->band && peak >= before
+        && peak > getStepThreshold (detector)
+        && detector->since_step > STEP_REFRACTORY)
+    {
+        detector->peak_avg += (peak - detector->peak_avg) >> STEP_PEAK_SHIFT;
+        detector->since_step = 0;
+        detector->steps++;
+        step = true;
+    }
+    else if (detector->since_step > STEP_TIMEOUT)
+    {
+        detector->peak_avg -= detector->peak_avg >> STEP_PEAK_SHIFT;
+    }
+    return step;
+}
+
+uint32_t
+getStepCount (const stepDetect_t *detector)
+{
+    return detector->steps;
+}
@@ -0,0 +1,87 @@
+#ifndef STEPDETECT_H_
+#define STEPDETECT_H_
+
+/**********************************************************
+ *
+ * stepDetect.h
+ *
+ * Streaming step detector. Each sample goes through these
+ * stages:
+ *
+ *  1. Squared magnitude. This is independent of how the
+ *     board is held, and needs no square root.
+ *  2. Band-pass. A first order low-pass (about 4 Hz) takes
+ *     out sensor noise and the sharpest heel strike edges.
+ *     Subtracting a slow average (about 0.25 Hz) then takes
+ *     out gravity.
+ *  3. Peak detection. A local maximum counts as a step if it
+ *     is above the adaptive threshold and at least
+ *     STEP_REFRACTORY samples after the previous step.
+ *
+ * The threshold is half a running average of recent step
+ * peaks, and never goes below STEP_MIN_THRESHOLD. After
+ * STEP_TIMEOUT samples with no step the average decays,
+ * so the detector picks up a gentler gait.
+ *
+ * The state is a few words, and each sample costs a fixed
+ * handful of integer operations. host/stepScore.c scores
+ * the detector against the labelled traces.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    25th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vector3.h"
+
+/**********************************************************
+ * Constants, in samples at ACCL_SAMPLE_RATE_HZ (100 Hz)
+ **********************************************************/
+#define STEP_MAG_SHIFT      8   // |a|^2 >> 8: 256 units at 1 g
+#define STEP_FRAC_BITS      4   // Fraction bits kept in the filters
+#define STEP_LP_SHIFT       2   // Low-pass, alpha 1/4
+#define STEP_DC_SHIFT       6   // Gravity tracker, alpha 1/64
+#define STEP_PEAK_SHIFT     2   // Peak average, alpha 1/4
+#define STEP_MIN_THRESHOLD  24  // Band-pass units, about 0.05 g
+#define STEP_REFRACTORY     25  // 0.25 s, at most 4 steps per second
+#define STEP_TIMEOUT        200 // 2 s without a step relaxes the threshold
+
+// *******************************************************
+// Detector state
+typedef struct {
+    int32_t lowpass;        // Low-passed |a|^2, STEP_FRAC_BITS
+    int32_t dc;             // Slow average of |a|^2, STEP_FRAC_BITS
+    int16_t band;           // Last band-pass output
+    int16_t prev_band;      // The one before it
+    int16_t peak_avg;       // Running average of step peaks
+    uint16_t since_step;    // Samples since the last step, saturating
+    uint32_t steps;
+    bool primed;            // Filters have been seeded
+} stepDetect_t;
+
+// *******************************************************
+// initStepDetect: Clears the state and the step count.
+void
+initStepDetect (stepDetect_t *detector);
+
+// *******************************************************
+// updateStepDetect: Processes one sample. Returns true if it
+// completes a step. The step is reported one sample after
+// its peak.
+bool
+updateStepDetect (stepDetect_t *detector, vector3_t sample);
+
+// *******************************************************
+// getStepCount: Steps since initStepDetect().
+uint32_t
+getStepCount (const stepDetect_t *detector);
+
+// *******************************************************
+// getStepThreshold: Peak height currently needed for a step,
+// in band-pass units.
+int16_t
+getStepThreshold (const stepDetect_t *detector);
+
+#endif /* STEPDETECT_H_ */
@@ -0,0 +1,337 @@
+/**********************************************************
+ *
+ * stepLog.c
+ *
+ * Persistent step log in internal flash, see stepLog.h.
+ *
+ * Sector layout, in 32-bit words:
+ *   0      STEPLOG_MAGIC | sequence number
+ *   1      total seconds before the first record
+ *   2      total steps before the first record
+ *   3...   records
+ * Words 1 and 2 are programmed before word 0, so a sector
+ * with the magic number has a complete header.
+ *
+ * A record is one length byte, the payload, and a CRC-8 over
+ * both. It is padded with 0xFF to whole words. The payload is
+ * a type byte then varints (7 bits a byte, low first).
+ * Flash is programmed a word at a time, in order. An append
+ * cut short therefore leaves either an erased first word,
+ * which is the end of the log, or a length with a bad CRC,
+ * which is skipped.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    9th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "driverlib/flash.h"
+#include "crc8.h"
+#include "stepLog.h"
+
+#ifdef HOST_BUILD
+#define FLASH_WORDS(addr)   hostFlashAt (addr)
+#else
+#define FLASH_WORDS(addr)   ((const uint32_t *) (addr))
+#endif
+
+#define STEPLOG_MAGIC       0x53540000  // "ST"
+#define MAGIC_MASK          0xFFFF0000
+#define HEADER_BYTES        12
+#define ERASED              0xFFFFFFFF
+#define MAX_PAYLOAD         11          // Type and two 5 byte varints
+#define MAX_RECORD_WORDS    4           // Length, payload and CRC, padded
+
+#define SECTOR_ADDR(s)      (STEPLOG_BASE + (uint32_t) (s) * STEPLOG_SECTOR_SIZE)
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static uint16_t cur_sector;
+static uint16_t cur_seq;
+static uint32_t write_addr;             // Next free word in cur_sector
+static bool sector_full;                // Unreadable records, do not append
+static uint32_t total_seconds;
+static uint32_t total_steps;
+static uint32_t num_records;
+static uint32_t num_torn;
+
+/*********************************************************
+ * Encoding
+ *********************************************************/
+static uint8_t
+putVarint (uint8_t *out, uint32_t value)
+{
+    uint8_t len = 0;
+
+    while (value >= 0x80)
+    {
+        out[len++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    out[len++] = value;
+    return len;
+}
+
+// Returns the bytes used, or 0 if the varint runs past end.
+static uint8_t
+getVarint (const uint8_t *in, const uint8_t *end, uint32_t *value)
+{
+    uint8_t len = 0;
+
+    *value = 0;
+    while (in + len < end && len < 5)
+    {
+        *value |= (uint32_t) (in[len] & 0x7F) << (7 * len);
+        if ((in[len++] & 0x80) == 0)
+            return len;
+    }
+    return 0;
+}
+
+/*********************************************************
+ * readRecord: Decodes the record at addr. Returns its size
+ * in bytes, with *valid false if it is torn. Returns 0 at
+ * the end of the records and -1 if the length makes no
+ * sense, after which nothing in the sector can be trusted.
+ *********************************************************/
+static int16_t
+readRecord (uint32_t addr, uint32_t end, bool *valid, uint8_t *type,
+            uint32_t *seconds, uint32_t *steps)
+{
+    const uint32_t *words = FLASH_WORDS (addr);
+    uint32_t copy[MAX_RECORD_WORDS];
+    const uint8_t *bytes = (const uint8_t *) copy;
+    const uint8_t *payload_end;
+    uint8_t len, used, size, i;
+
+    if (addr + 4 > end || words[0] == ERASED)
+        return 0;
+    copy[0] = words[0];
+    len = bytes[0];
+    size = (len + 2 + 3) & ~3;
+    if (len == 0 || len > MAX_PAYLOAD || addr + size > end)
+        return -1;
+    for (i = 1; i < size / 4; i++)
+        copy[i] = words[i];
+
+    *valid = false;
+    if (crc8 (bytes, len + 1) != bytes[len + 1])
+        return size;
+    for (i = len + 2; i < size; i++)
+        if (bytes[i] != 0xFF)
+            return size;
+    *type = bytes[1];
+    *seconds = 0;
+    *steps = 0;
+    payload_end = &bytes[len + 1];
+    if (*type == STEPLOG_STEPS)
+    {
+        used = getVarint (&bytes[2], payload_end, seconds);
+        if (used == 0 || getVarint (&bytes[2 + used], payload_end, steps) == 0)
+            return size;
+    }
+    else if (*type != STEPLOG_BOOT)
+        return size;
+    *valid = true;
+    return size;
+}
+
+/*********************************************************
+ * Sectors
+ *********************************************************/
+static bool
+readHeader (uint16_t sector, uint16_t *seq, uint32_t *seconds, uint32_t *steps)
+{
+    const uint32_t *words = FLASH_WORDS (SECTOR_ADDR (sector));
+
+    if ((words[0] & MAGIC_MASK) != STEPLOG_MAGIC)
+        return false;
+    *seq = words[0] & ~MAGIC_MASK;
+    *seconds = words[1];
+    *steps = words[2];
+    return true;
+}
+
+// Walks the records of one sector from its header totals. Returns the
+// address after the last record, or 0 if the sector is unreadable
+// from some point on.
+static uint32_t
+scanSector (uint16_t sector, uint32_t *seconds, uint32_t *steps,
+            stepLogVisit_t visit, void *arg)
+{
+    uint32_t addr = SECTOR_ADDR (sector) + HEADER_BYTES;
+    uint32_t end = SECTOR_ADDR (sector) + STEPLOG_SECTOR_SIZE;
+    uint32_t dt, ds;
+    uint8_t type;
+    int16_t size;
+    bool valid;
+
+    while ((size = readRecord (addr, end, &valid, &type, &dt, &ds)) > 0)
+    {
+        if (valid)
+        {
+            *seconds += dt;
+            *steps += ds;
+            if (visit != NULL)
+                visit (type, *seconds, *steps, arg);
+            else
+                num_records++;
+        }
+        else if (visit == NULL)
+            num_torn++;
+        addr += size;
+    }
+    return (size == 0) ? addr : 0;
+}
+
+static bool
+startSector (uint16_t sector, uint16_t seq)
+{
+    uint32_t header[3];
+
+    header[0] = STEPLOG_MAGIC | seq;
+    header[1] = total_seconds;
+    header[2] = total_steps;
+    if (FlashErase (SECTOR_ADDR (sector)) != 0
+        || FlashProgram (&header[1], SECTOR_ADDR (sector) + 4, 8) != 0
+        || FlashProgram (&header[0], SECTOR_ADDR (sector), 4) != 0)
+        return false;
+    cur_sector = sector;
+    cur_seq = seq;
+    write_addr = SECTOR_ADDR (sector) + HEADER_BYTES;
+    sector_full = false;
+    num_records = 0;
+    num_torn = 0;
+    return true;
+}
+
+/*********************************************************
+ * appendRecord
+ *********************************************************/
+static bool
+appendRecord (uint8_t type, uint32_t seconds, uint32_t steps)
+{
+    uint32_t words[MAX_RECORD_WORDS];
+    uint8_t *bytes = (uint8_t *) words;
+    uint8_t len, size, i;
+
+    for (i = 0; i < MAX_RECORD_WORDS; i++)
+        words[i] = ERASED;
+    bytes[1] = type;
+    len = 1;
+    if (type == STEPLOG_STEPS)
+    {
+        len += putVarint (&bytes[1 + len], seconds);
+        len += putVarint (&bytes[1 + len], steps);
+    }
+    bytes[0] = len;
+    bytes[len + 1] = crc8 (bytes, len + 1);
+    size = (len + 2 + 3) & ~3;
+
+    if (sector_full
+        || write_addr + size > SECTOR_ADDR (cur_sector) + STEPLOG_SECTOR_SIZE)
+    {
+        if (!startSector ((cur_sector + 1) % STEPLOG_SECTORS, cur_seq + 1))
+            return false;
+    }
+    // Counted as written even if it fails: its space is used either way
+    write_addr += size;
+    if (FlashProgram (words, write_addr - size, size) != 0)
+        return false;
+    total_seconds += seconds;
+    total_steps += steps;
+    num_records++;
+    return true;
+}
+
+/*********************************************************
+ * initStepLog
+ *********************************************************/
+bool
+initStepLog (void)
+{
+    uint16_t sector, seq;
+    uint32_t seconds, steps;
+    bool found = false;
+
+    for (sector = 0; sector < STEPLOG_SECTORS; sector++)
+    {
+        if (readHeader (sector, &seq, &seconds, &steps)
+            && (!found || (int16_t) (seq - cur_seq) > 0))
+        {
+            found = true;
+            cur_sector = sector;
+            cur_seq = seq;
+            total_seconds = seconds;
+            total_steps = steps;
+        }
+    }
+
+    num_records = 0;
+    num_torn = 0;
+    if (!found)
+    {
+        total_seconds = 0;
+        total_steps = 0;
+        if (!startSector (0, 0))
+            return false;
+    }
+    else
+    {
+        write_addr = scanSector (cur_sector, &total_seconds, &total_steps,
+                                 NULL, NULL);
+        sector_full = (write_addr == 0);
+    }
+    return appendRecord (STEPLOG_BOOT, 0, 0);
+}
+
+bool
+stepLogAppend (uint32_t seconds, uint32_t steps)
+{
+    return appendRecord (STEPLOG_STEPS, seconds, steps);
+}
+
+uint32_t
+stepLogSteps (void)
+{
+    return total_steps;
+}
+
+uint32_t
+stepLogSeconds (void)
+{
+    return total_seconds;
+}
+
+/*********************************************************
+ * stepLogForEach: Sectors are filled round robin, so the
+ * oldest follows the current one.
+ *********************************************************/
+void
+stepLogForEach (stepLogVisit_t visit, void *arg)
+{
+    uint16_t i, sector, seq;
+    uint32_t seconds, steps;
+
+    for (i = 1; i <= STEPLOG_SECTORS; i++)
+    {
+        sector = (cur_sector + i) % STEPLOG_SECTORS;
+        if (readHeader (sector, &seq, &seconds, &steps))
+            scanSector (sector, &seconds, &steps, visit, arg);
+    }
+}
+
+void
+stepLogGetStats (stepLogStats_t *stats)
+{
+    stats->records = num_records;
+    stats->torn = num_torn;
+    stats->sector = cur_sector;
+    stats->sequence = cur_seq;
+    stats->free_bytes = sector_full ? 0
+        : SECTOR_ADDR (cur_sector) + STEPLOG_SECTOR_SIZE - write_addr;
+}
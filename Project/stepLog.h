@@ -0,0 +1,89 @@
+#ifndef STEPLOG_H_
+#define STEPLOG_H_
+
+/**********************************************************
+ *
+ * stepLog.h
+ *
+ * Persistent step log in the top STEPLOG_SECTORS 1 KB
+ * sectors of internal flash. Records are appended in turn
+ * and the sectors are used round robin, so each one is
+ * erased equally often. Once all are full, the oldest
+ * sector is erased to make room.
+ *
+ * Each record holds the seconds and steps since the record
+ * before it, as varints. A minute of walking takes 8 bytes.
+ * Each sector begins with the running totals, so it can be
+ * read on its own after the older ones are gone.
+ *
+ * An append that is cut short by a reset fails its check
+ * byte and is skipped when the log is recovered. Everything
+ * written before it is kept.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    9th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+#define STEPLOG_BASE        0x0003E000  // Kept out of FLASH in tm4c123gh6pm.cmd
+#define STEPLOG_SECTORS     8
+#define STEPLOG_SECTOR_SIZE 1024        // Flash erase size
+#define STEPLOG_PERIOD_S    60          // How often main() logs new steps
+
+enum stepLogTypes {STEPLOG_STEPS = 1, STEPLOG_BOOT};
+
+// *******************************************************
+// stepLogVisit_t: Called for each record, oldest first, with
+// the totals as of that record.
+typedef void (*stepLogVisit_t) (uint8_t type, uint32_t seconds,
+                                uint32_t steps, void *arg);
+
+typedef struct {
+    uint32_t records;       // Good records in the newest sector
+    uint32_t torn;          // Records skipped for a bad check byte
+    uint16_t sector;        // Sector being appended to
+    uint16_t sequence;      // Its sequence number
+    uint16_t free_bytes;    // Room left in it
+} stepLogStats_t;
+
+// *******************************************************
+// initStepLog: Finds the newest sector and the end of its
+// records, restores the totals and appends a boot record. A
+// blank or unreadable log is started afresh. Returns false if
+// flash could not be written.
+bool
+initStepLog (void);
+
+// *******************************************************
+// stepLogAppend: Logs steps taken over the last seconds.
+// Returns false if flash could not be written.
+bool
+stepLogAppend (uint32_t seconds, uint32_t steps);
+
+// *******************************************************
+// stepLogSteps, stepLogSeconds: Totals over every record
+// ever logged, including those in erased sectors.
+uint32_t
+stepLogSteps (void);
+
+uint32_t
+stepLogSeconds (void);
+
+// *******************************************************
+// stepLogForEach: Visits every record still in flash.
+void
+stepLogForEach (stepLogVisit_t visit, void *arg);
+
+// *******************************************************
+// stepLogGetStats: State found by initStepLog() and updated
+// by appends since.
+void
+stepLogGetStats (stepLogStats_t *stats);
+
+#endif /* STEPLOG_H_ */
@@ -0,0 +1,355 @@
+/**********************************************************
+ *
+ * telemetry.c
+ *
+ * COBS framed telemetry over UART0 with uDMA ping-pong
+ * transmit, see telemetry.h.
+ *
+ * Buffers are sent in order. At most two are armed, one in
+ * each of channel 9's control structures. The TM4C123 has no
+ * uDMA done flag for UART channels, but the finished
+ * structure reads back as UDMA_MODE_STOP. So UART0IntHandler
+ * retires armed buffers, oldest first, while their structure
+ * has stopped, then arms the buffers waiting behind them. If
+ * the channel ran dry it is re-enabled on the structure the
+ * next buffer was armed on.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    10th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_uart.h"
+#include "driverlib/gpio.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "crc8.h"
+#include "profile.h"
+#include "telemetry.h"
+
+#define TELEM_CHANNEL       UDMA_CHANNEL_UART0TX
+// Worst case frame: COBS code byte, type, seq, payload, crc, delimiter
+#define TELEM_MAX_FRAME     (TELEM_MAX_PAYLOAD + 5)
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+// The control table must be 1024 byte aligned.
+#ifdef __TI_COMPILER_VERSION__
+#pragma DATA_ALIGN(dma_table, 1024)
+static uint8_t dma_table[1024];
+#else
+static uint8_t dma_table[1024] __attribute__ ((aligned (1024)));
+#endif
+
+static uint8_t slots[TELEM_SLOTS][TELEM_SLOT_SIZE];
+static uint16_t slot_len[TELEM_SLOTS];
+static uint8_t slot_ctrl[TELEM_SLOTS];  // UDMA_PRI_SELECT or UDMA_ALT_SELECT
+
+static volatile uint8_t tx_slot;        // Oldest queued buffer
+static volatile uint8_t num_queued;     // Closed, waiting or armed
+static volatile uint8_t num_armed;      // In a control structure, 0 to 2
+static uint8_t next_ctrl;               // Structure the next buffer goes in
+static uint8_t fill_slot;               // Buffer frames are encoded into
+
+static uint8_t seq;
+static uint32_t dropped;
+static uint8_t profile_stage;
+
+/*********************************************************
+ * armSlots: Puts queued buffers into free control
+ * structures, alternating between them. Called with
+ * interrupts masked or from UART0IntHandler.
+ *********************************************************/
+static void
+armSlots (void)
+{
+    uint8_t slot;
+
+    while (num_armed < 2 && num_armed < num_queued)
+    {
+        slot = (tx_slot + num_armed) % TELEM_SLOTS;
+        slot_ctrl[slot] = next_ctrl;
+        next_ctrl ^= UDMA_ALT_SELECT;
+        uDMAChannelTransferSet (TELEM_CHANNEL | slot_ctrl[slot],
+                                UDMA_MODE_PINGPONG, slots[slot],
+                                (void *) (UART0_BASE + UART_O_DR),
+                                slot_len[slot]);
+        num_armed++;
+
+        if (!uDMAChannelIsEnabled (TELEM_CHANNEL))
+        {
+            if (slot_ctrl[slot] == UDMA_ALT_SELECT)
+                uDMAChannelAttributeEnable (TELEM_CHANNEL, UDMA_ATTR_ALTSELECT);
+            else
+                uDMAChannelAttributeDisable (TELEM_CHANNEL, UDMA_ATTR_ALTSELECT);
+            uDMAChannelEnable (TELEM_CHANNEL);
+        }
+    }
+}
+
+/*********************************************************
+ * closeSlot: Queues the fill buffer for sending and moves
+ * on to the next one. Returns false if all are queued.
+ *********************************************************/
+static bool
+closeSlot (void)
+{
+    bool was_masked;
+
+    if (slot_len[fill_slot] > 0)
+    {
+        was_masked = IntMasterDisable ();
+        num_queued++;
+        armSlots ();
+        if (!was_masked)
+            IntMasterEnable ();
+        fill_slot = (fill_slot + 1) % TELEM_SLOTS;
+        slot_len[fill_slot] = 0;
+    }
+    return num_queued < TELEM_SLOTS;
+}
+
+/*********************************************************
+ * cobsEncode: Encodes len (< 254) bytes so that the output
+ * has no zeros, and appends the 0x00 delimiter. Returns the
+ * number of bytes written, at most len + 2.
+ *********************************************************/
+static uint8_t
+cobsEncode (const uint8_t *src, uint8_t len, uint8_t *dst)
+{
+    uint8_t code_at = 0;
+    uint8_t out = 1;
+    uint8_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (src[i] == 0)
+        {
+            dst[code_at] = out - code_at;
+            code_at = out++;
+        }
+        else
+            dst[out++] = src[i];
+    }
+    dst[code_at] = out - code_at;
+    dst[out++] = 0;
+    return out;
+}
+
+static void
+put16 (uint8_t *bytes, int16_t value)
+{
+    bytes[0] = (uint16_t) value & 0xFF;
+    bytes[1] = (uint16_t) value >> 8;
+}
+
+static void
+put32 (uint8_t *bytes, uint32_t value)
+{
+    bytes[0] = value & 0xFF;
+    bytes[1] = (value >> 8) & 0xFF;
+    bytes[2] = (value >> 16) & 0xFF;
+    bytes[3] = value >> 24;
+}
+
+/*********************************************************
+ * initTelemetry
+ *********************************************************/
+void
+initTelemetry (void)
+{
+    SysCtlPeripheralEnable (SYSCTL_PERIPH_UART0);
+    SysCtlPeripheralEnable (SYSCTL_PERIPH_GPIOA);
+    SysCtlPeripheralEnable (SYSCTL_PERIPH_UDMA);
+    GPIOPinConfigure (GPIO_PA0_U0RX);
+    GPIOPinConfigure (GPIO_PA1_U0TX);
+    GPIOPinTypeUART (GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
+
+    UARTConfigSetExpClk (UART0_BASE, SysCtlClockGet (), TELEM_BAUD,
+                         UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE
+                         | UART_CONFIG_PAR_NONE);
+    UARTFIFOLevelSet (UART0_BASE, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+    UARTEnable (UART0_BASE);
+    UARTDMAEnable (UART0_BASE, UART_DMA_TX);
+
+    uDMAEnable ();
+    uDMAControlBaseSet (dma_table);
+    uDMAChannelAssign (UDMA_CH9_UART0TX);
+    uDMAChannelAttributeDisable (TELEM_CHANNEL, UDMA_ATTR_ALL);
+    uDMAChannelAttributeEnable (TELEM_CHANNEL, UDMA_ATTR_USEBURST);
+    uDMAChannelControlSet (TELEM_CHANNEL | UDMA_PRI_SELECT, UDMA_SIZE_8
+                           | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_4);
+    uDMAChannelControlSet (TELEM_CHANNEL | UDMA_ALT_SELECT, UDMA_SIZE_8
+                           | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_4);
+
+    tx_slot = 0;
+    num_queued = 0;
+    num_armed = 0;
+    next_ctrl = UDMA_PRI_SELECT;
+    fill_slot = 0;
+    slot_len[0] = 0;
+    seq = 0;
+    dropped = 0;
+    profile_stage = 0;
+
+    IntEnable (INT_UART0);
+}
+
+/*********************************************************
+ * telemetrySend
+ *********************************************************/
+bool
+telemetrySend (uint8_t type, const uint8_t *payload, uint8_t len)
+{
+    uint8_t frame[TELEM_MAX_PAYLOAD + 3];
+    uint8_t i;
+
+    if (len > TELEM_MAX_PAYLOAD)
+        return false;
+
+    frame[0] = type;
+    frame[1] = seq++;
+    for (i = 0; i < len; i++)
+        frame[2 + i] = payload[i];
+    frame[2 + len] = crc8 (frame, len + 2);
+
+    if (slot_len[fill_slot] + len + 5 > TELEM_SLOT_SIZE && !closeSlot ())
+    {
+        dropped++;
+        return false;
+    }
+    if (num_queued == TELEM_SLOTS)  // The fill buffer is still being sent
+    {
+        dropped++;
+        return false;
+    }
+    slot_len[fill_slot] += cobsEncode (frame, len + 3,
+                                       &slots[fill_slot][slot_len[fill_slot]]);
+    return true;
+}
+
+void
+telemetryFlush (void)
+{
+    closeSlot ();
+}
+
+bool
+telemetryPending (void)
+{
+    return slot_len[fill_slot] > 0;
+}
+
+bool
+telemetryIdle (void)
+{
+    return num_queued == 0 && !UARTBusy (UART0_BASE);
+}
+
+uint32_t
+telemetryDropped (void)
+{
+    return dropped;
+}
+
+/*********************************************************
+ * Typed records
+ *********************************************************/
+void
+telemetryRaw (vector3_t sample)
+{
+    uint8_t payload[6];
+
+    put16 (&payload[0], sample.x);
+    put16 (&payload[2], sample.y);
+    put16 (&payload[4], sample.z);
+    telemetrySend (TELEM_RAW, payload, sizeof (payload));
+}
+
+void
+telemetryFiltered (vector3_t mean, int16_t pitch, int16_t roll)
+{
+    uint8_t payload[10];
+
+    put16 (&payload[0], mean.x);
+    put16 (&payload[2], mean.y);
+    put16 (&payload[4], mean.z);
+    put16 (&payload[6], pitch);
+    put16 (&payload[8], roll);
+    telemetrySend (TELEM_FILTERED, payload, sizeof (payload));
+}
+
+void
+telemetryStep (uint32_t count, uint32_t ms)
+{
+    uint8_t payload[8];
+
+    put32 (&payload[0], count);
+    put32 (&payload[4], ms);
+    telemetrySend (TELEM_STEP, payload, sizeof (payload));
+}
+
+void
+telemetryBatch (uint32_t time, uint8_t samples, uint32_t missed)
+{
+    uint8_t payload[9];
+
+    put32 (&payload[0], time);
+    payload[4] = samples;
+    put32 (&payload[5], missed);
+    telemetrySend (TELEM_BATCH, payload, sizeof (payload));
+}
+
+void
+telemetryProfile (void)
+{
+    uint8_t payload[17];
+    uint32_t count;
+    uint32_t min;
+    uint32_t mean;
+    uint32_t max;
+    uint8_t tries;
+
+    for (tries = 0; tries < NUM_PROF_STAGES; tries++)
+    {
+        payload[0] = profile_stage;
+        profile_stage = (profile_stage + 1) % NUM_PROF_STAGES;
+        if (profileStageSummary (payload[0], &count, &min, &mean, &max))
+        {
+            put32 (&payload[1], count);
+            put32 (&payload[5], min);
+            put32 (&payload[9], mean);
+            put32 (&payload[13], max);
+            telemetrySend (TELEM_PROFILE, payload, sizeof (payload));
+            return;
+        }
+    }
+}
+
+/*********************************************************
+ * UART0IntHandler: retires the buffers whose control
+ * structure has stopped and arms the ones waiting.
+ *********************************************************/
+void
+UART0IntHandler (void)
+{
+    UARTIntClear (UART0_BASE, UARTIntStatus (UART0_BASE, true));
+
+    while (num_armed > 0 && uDMAChannelModeGet (TELEM_CHANNEL
+                                                | slot_ctrl[tx_slot])
+                            == UDMA_MODE_STOP)
+    {
+        tx_slot = (tx_slot + 1) % TELEM_SLOTS;
+        num_armed--;
+        num_queued--;
+    }
+    armSlots ();
+}
@@ -0,0 +1,117 @@
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+/**********************************************************
+ *
+ * telemetry.h
+ *
+ * Binary telemetry over UART0, the debug virtual COM port.
+ * Each record is framed as
+ *
+ *     [type] [seq] [payload ...] [crc8]
+ *
+ * then COBS encoded and ended with a 0x00 byte, so a reader
+ * can pick up the stream at any frame boundary. seq counts
+ * every frame, including dropped ones, so gaps show up at
+ * the far end. Multi-byte fields are little endian.
+ *
+ * Frames are encoded into one of TELEM_SLOTS buffers. Full
+ * buffers (or the one open at telemetryFlush()) are sent by
+ * uDMA channel 9 in ping-pong mode, so the next buffer is
+ * already queued when one finishes. The CPU only runs the
+ * UART0 interrupt once per buffer. If every buffer is in
+ * use, new frames are dropped and counted.
+ *
+ * host/telemetryDecode.c decodes and records the stream.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    10th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vector3.h"
+
+/**********************************************************
+ * Constants
+ **********************************************************/
+#define TELEM_BAUD          115200
+#define TELEM_SLOTS         4       // Transmit buffers
+#define TELEM_SLOT_SIZE     64      // Bytes per buffer, at most 1024
+#define TELEM_MAX_PAYLOAD   32
+
+// Frame types and their payloads.
+enum telemetryTypes {TELEM_RAW = 1,     // x, y, z (int16)
+                     TELEM_FILTERED,    // mean x, y, z, pitch, roll (int16)
+                     TELEM_STEP,        // count, ms (uint32)
+                     TELEM_PROFILE,     // stage (uint8), count, min, mean,
+                                        // max (uint32)
+                     TELEM_BATCH};      // time (uint32), samples (uint8),
+                                        // missed (uint32)
+
+// *******************************************************
+// initTelemetry: Sets up UART0 on PA0/PA1 at TELEM_BAUD and
+// uDMA channel 9 to feed its transmit FIFO.
+void
+initTelemetry (void);
+
+// *******************************************************
+// telemetrySend: Frames len bytes of payload as type and
+// queues it. Returns false if it was dropped.
+bool
+telemetrySend (uint8_t type, const uint8_t *payload, uint8_t len);
+
+// *******************************************************
+// telemetryFlush: Sends the partly filled buffer, if any.
+// main() runs it as a task whenever frames are pending.
+void
+telemetryFlush (void);
+
+// *******************************************************
+// telemetryPending: True if frames have been queued since
+// the last telemetryFlush().
+bool
+telemetryPending (void);
+
+// *******************************************************
+// telemetryIdle: True once everything queued has left the
+// UART, so the clocks can be stopped.
+bool
+telemetryIdle (void);
+
+// *******************************************************
+// telemetryDropped: Frames dropped for lack of a buffer.
+uint32_t
+telemetryDropped (void);
+
+// *******************************************************
+// Typed records.
+void
+telemetryRaw (vector3_t sample);
+
+void
+telemetryFiltered (vector3_t mean, int16_t pitch, int16_t roll);
+
+void
+telemetryStep (uint32_t count, uint32_t ms);
+
+// *******************************************************
+// telemetryBatch: Sent ahead of a batch of raw records with
+// the first one's timestamp (Timer1 cycles, see readAcc.c),
+// how many follow, and acclMissedSamples() so far.
+void
+telemetryBatch (uint32_t time, uint8_t samples, uint32_t missed);
+
+// *******************************************************
+// telemetryProfile: Sends the next profiled stage's count,
+// min, mean and max. Each call moves on one stage.
+void
+telemetryProfile (void);
+
+// *******************************************************
+// UART0IntHandler: Runs when a uDMA buffer has been sent.
+void
+UART0IntHandler (void);
+
+#endif /* TELEMETRY_H_ */
@@ -10,7 +10,8 @@
 
 MEMORY
 {
-    FLASH (RX) : origin = 0x00000000, length = 0x00040000
+    /* The top 8 KB, from 0x0003E000, is the step log (stepLog.h) */
+    FLASH (RX) : origin = 0x00000000, length = 0x0003E000
     SRAM (RWX) : origin = 0x20000000, length = 0x00008000
 }
 
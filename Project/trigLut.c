@@ -0,0 +1,97 @@
+/**********************************************************
+ *
+ * trigLut.c
+ *
+ * Interpolated atan and 1/sqrt tables, see trigLut.h.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include "trigLut.h"
+
+// Count of leading zeros, one instruction on the M4.
+#if defined(__TI_ARM__) || defined(__TMS470__)
+#define LUT_CLZ(x)      _norm (x)
+#else
+#define LUT_CLZ(x)      __builtin_clz (x)
+#endif
+
+#define ATAN_FRAC_BITS  (16 - ATAN_LUT_BITS)
+
+/*********************************************************
+ * atanLutCentideg: the ratio is formed in Q16. Its top
+ * ATAN_LUT_BITS pick the interval and the rest interpolate.
+ *********************************************************/
+int16_t
+atanLutCentideg (uint32_t num, uint32_t den)
+{
+    uint32_t r;
+    uint32_t i;
+    uint32_t frac;
+    uint32_t value;
+
+    if (den == 0)
+        return 0;
+    r = (num << 16) / den;
+    i = r >> ATAN_FRAC_BITS;
+    frac = r & ((1 << ATAN_FRAC_BITS) - 1);
+    value = atan_lut[i];
+    if (frac != 0)
+        value += ((atan_lut[i + 1] - value) * frac) >> ATAN_FRAC_BITS;
+    return (value + (1 << (ATAN_LUT_FRAC - 1))) >> ATAN_LUT_FRAC;
+}
+
+/*********************************************************
+ * normalise: shifts x left by an even 2k bits into
+ * [2^30, 2^32), where x / 2^30 = u is in [1, 4), and
+ * interpolates 2^15 / sqrt(u) from the table. Then
+ * 1 / sqrt(x) = that * 2^(k - 30).
+ *********************************************************/
+static uint32_t
+invSqrtNorm (uint32_t x, uint8_t *k, uint32_t *x_norm)
+{
+    uint32_t i;
+    uint32_t frac;
+    uint32_t v;
+
+    *k = LUT_CLZ (x) >> 1;
+    x <<= 2 * *k;
+    *x_norm = x;
+    i = (x >> (30 - INVSQRT_LUT_BITS)) - (1 << INVSQRT_LUT_BITS);
+    frac = (x >> (22 - INVSQRT_LUT_BITS)) & 0xFF;
+    v = invsqrt_lut[i];
+    return v - (((v - invsqrt_lut[i + 1]) * frac + 0x80) >> 8);
+}
+
+uint32_t
+invSqrtLut (uint32_t x)
+{
+    uint8_t k;
+    uint32_t x_norm;
+
+    if (x == 0)
+        return 0xFFFFFFFF;
+    return invSqrtNorm (x, &k, &x_norm) << (k + 1);
+}
+
+/*********************************************************
+ * sqrtLut: sqrt(x) = x / sqrt(x), worked on the normalised
+ * x so the product stays in 32 bits.
+ *********************************************************/
+uint16_t
+sqrtLut (uint32_t x)
+{
+    uint8_t k;
+    uint32_t x_norm;
+    uint32_t v;
+    uint32_t root;
+
+    if (x == 0)
+        return 0;
+    v = invSqrtNorm (x, &k, &x_norm);
+    root = ((x_norm >> 15) * v + (1UL << (14 + k))) >> (15 + k);
+    return (root > 0xFFFF) ? 0xFFFF : root;
+}
@@ -0,0 +1,54 @@
+#ifndef TRIGLUT_H_
+#define TRIGLUT_H_
+
+/**********************************************************
+ *
+ * trigLut.h
+ *
+ * Interpolated lookup tables for atan and 1/sqrt. Each call
+ * is one table lookup and one multiply for the linear
+ * interpolation, plus the division that forms the ratio for
+ * atan and a count of leading zeros for 1/sqrt. The tables
+ * are in trigTables.c, which host/genTables.py generates.
+ * They are const, so they are linked into flash.
+ *
+ * Maximum errors, as measured by host/orientReport.c:
+ *   atanLutCentideg   0.7 centidegrees, 0.5 of it from
+ *                     rounding to whole centidegrees
+ *   invSqrtLut        0.017%
+ *   sqrtLut           0.017% plus rounding to counts
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+
+/**********************************************************
+ * Constants (must match host/genTables.py)
+ **********************************************************/
+#define ATAN_LUT_BITS       6       // 2^6 intervals of the ratio over [0, 1]
+#define ATAN_LUT_FRAC       3       // Entries are centidegrees << 3
+#define INVSQRT_LUT_BITS    5       // 2^5 intervals per unit over [1, 4]
+
+extern const uint16_t atan_lut[(1 << ATAN_LUT_BITS) + 1];
+extern const uint16_t invsqrt_lut[3 * (1 << INVSQRT_LUT_BITS) + 1];
+
+// *******************************************************
+// atanLutCentideg: atan(num / den) in centidegrees, 0 to
+// 4500. Needs num <= den < 65536. 0 if den is 0.
+int16_t
+atanLutCentideg (uint32_t num, uint32_t den);
+
+// *******************************************************
+// invSqrtLut: 2^31 / sqrt(x), rounded. 0xFFFFFFFF for 0.
+uint32_t
+invSqrtLut (uint32_t x);
+
+// *******************************************************
+// sqrtLut: sqrt(x), rounded.
+uint16_t
+sqrtLut (uint32_t x);
+
+#endif /* TRIGLUT_H_ */
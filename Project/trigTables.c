@@ -0,0 +1,41 @@
+/**********************************************************
+ *
+ * trigTables.c
+ *
+ * GENERATED by host/genTables.py, do not edit. Lookup tables
+ * for trigLut.c, placed in flash (.const).
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include "trigLut.h"
+
+// atan(i / 64) in centidegrees << 3, i = 0..64
+const uint16_t atan_lut[65] = {
+        0,   716,  1432,  2147,  2861,  3574,  4285,  4994,
+     5700,  6404,  7105,  7802,  8496,  9186,  9871, 10552,
+    11229, 11901, 12567, 13228, 13883, 14533, 15176, 15814,
+    16445, 17069, 17688, 18299, 18904, 19501, 20092, 20676,
+    21252, 21821, 22384, 22939, 23486, 24027, 24560, 25086,
+    25604, 26116, 26620, 27117, 27607, 28090, 28565, 29034,
+    29496, 29951, 30399, 30840, 31275, 31703, 32125, 32540,
+    32949, 33351, 33748, 34138, 34522, 34900, 35272, 35639,
+    36000,
+};
+
+// 2^15 / sqrt(j / 32), j = 32..128
+const uint16_t invsqrt_lut[97] = {
+    32768, 32268, 31790, 31332, 30894, 30474, 30070, 29682,
+    29309, 28949, 28602, 28268, 27945, 27632, 27330, 27038,
+    26755, 26481, 26214, 25956, 25705, 25462, 25225, 24994,
+    24770, 24552, 24339, 24132, 23930, 23733, 23541, 23354,
+    23170, 22992, 22817, 22646, 22479, 22315, 22155, 21999,
+    21845, 21695, 21548, 21404, 21263, 21124, 20988, 20855,
+    20724, 20596, 20470, 20346, 20225, 20106, 19988, 19873,
+    19760, 19649, 19539, 19431, 19326, 19221, 19119, 19018,
+    18919, 18821, 18725, 18630, 18536, 18444, 18354, 18264,
+    18176, 18090, 18004, 17920, 17837, 17755, 17674, 17594,
+    17515, 17438, 17361, 17285, 17211, 17137, 17064, 16992,
+    16921, 16851, 16782, 16714, 16646, 16579, 16514, 16448,
+    16384,
+};
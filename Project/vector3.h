@@ -0,0 +1,24 @@
+/**********************************************************
+ *
+ * vector3.h
+ *
+ * Three axis acceleration sample, in ADXL345 counts. The
+ * layout matches DATAX0..DATAZ1 on a little-endian core.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    21st of April 2022
+ *
+ **********************************************************/
+
+#ifndef VECTOR3_H_
+#define VECTOR3_H_
+
+#include <stdint.h>
+
+typedef struct vector{
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} vector3_t;
+
+#endif /* VECTOR3_H_ */
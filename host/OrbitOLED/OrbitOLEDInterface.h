@@ -0,0 +1,17 @@
+//*****************************************************************************
+//
+// OrbitOLEDInterface.h - Host stand-in for the Orbit OLED interface.
+//
+// The host model keeps a 4 x 16 character frame buffer (see hostOled.c).
+//
+//*****************************************************************************
+
+#ifndef ORBITOLEDINTERFACE_H_
+#define ORBITOLEDINTERFACE_H_
+
+#include <stdint.h>
+
+void OLEDInitialise (void);
+void OLEDStringDraw (const char *pcStr, uint32_t ulColumn, uint32_t ulRow);
+
+#endif /* ORBITOLEDINTERFACE_H_ */
@@ -0,0 +1,367 @@
+/**********************************************************
+ *
+ * bench.c
+ *
+ * Host benchmark of the firmware's per-sample code over the
+ * recorded traces. Each kernel runs over every sample of a
+ * trace and is repeated until about BENCH_MIN_NS has passed.
+ * The report gives ns per sample, throughput and a
+ * checksum of the kernel's outputs. A change to a hot path
+ * can then be compared in numbers: the checksum shows
+ * whether the results changed, and the timing shows what
+ * it cost.
+ *
+ *     make bench
+ *     ./build/bench traces/walking.csv ...
+ *
+ * Timings are for the host and only comparable with each
+ * other; see profile.h for cycles on target.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    4th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "circBufT.h"
+#include "readAcc.h"
+#include "readRollPitch.h"
+#include "movingAvg.h"
+#include "orientFixed.h"
+#include "stepDetect.h"
+#include "firFilter.h"
+#include "spscQueue.h"
+
+#define MAX_SAMPLES     200000
+#define BENCH_MIN_NS    20000000ULL     // Per kernel and trace
+#define BENCH_WINDOW    64              // Moving average window
+#define BENCH_BATCH     16              // Span size, as ACCL_FIFO_WATERMARK
+
+typedef struct {
+    const char *name;
+    uint32_t (*run) (const vector3_t *samples, uint32_t n);
+} kernel_t;
+
+static vector3_t samples[MAX_SAMPLES];
+static uint32_t num_samples;
+
+SPSC_DECLARE (copy_queue, ACCL_QUEUE_SIZE);
+SPSC_DECLARE (place_queue, ACCL_QUEUE_SIZE);
+CIRCBUF_DECLARE (bx, BUFF_SIZE);
+CIRCBUF_DECLARE (by, BUFF_SIZE);
+CIRCBUF_DECLARE (bz, BUFF_SIZE);
+
+static uint64_t
+wallNs (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// FNV-1a over one 16-bit output.
+static uint32_t
+mix (uint32_t hash, int32_t value)
+{
+    hash = (hash ^ (value & 0xFF)) * 16777619u;
+    return (hash ^ ((value >> 8) & 0xFF)) * 16777619u;
+}
+
+#define HASH_START  2166136261u
+
+// Back to the state CIRCBUF_DECLARE leaves a buffer in, so every run of
+// a kernel starts alike.
+static void
+emptyCircBuf (circBuf_t *buffer)
+{
+    buffer->windex = 0;
+    buffer->rindex = 0;
+    memset (buffer->data, 0, buffer->size * sizeof (buffer->data[0]));
+}
+
+/*********************************************************
+ * Kernels
+ *********************************************************/
+// The original buffering: three uint32_t circBuf_t, one write and one read
+// per axis per sample.
+static uint32_t
+runCircBufT (const vector3_t *s, uint32_t n)
+{
+    uint32_t hash = HASH_START;
+    uint32_t i;
+
+    emptyCircBuf (&bx);
+    emptyCircBuf (&by);
+    emptyCircBuf (&bz);
+    for (i = 0; i < n; i++)
+    {
+        writeCircBuf (&bx, s[i].x);
+        writeCircBuf (&by, s[i].y);
+        writeCircBuf (&bz, s[i].z);
+        hash = mix (hash, readCircBuf (&bx) + readCircBuf (&by)
+                          + readCircBuf (&bz));
+    }
+    return hash;
+}
+
+// The original means: calcMean() rescans each axis buffer every sample.
+static uint32_t
+runCalcMean (const vector3_t *s, uint32_t n)
+{
+    uint32_t hash = HASH_START;
+    uint32_t i;
+
+    emptyCircBuf (&bx);
+    emptyCircBuf (&by);
+    emptyCircBuf (&bz);
+    for (i = 0; i < n; i++)
+    {
+        writeCircBuf (&bx, s[i].x);
+        writeCircBuf (&by, s[i].y);
+        writeCircBuf (&bz, s[i].z);
+        hash = mix (hash, calcMean (0, 0, &bx));
+        hash = mix (hash, calcMean (0, 0, &by));
+        hash = mix (hash, calcMean (0, 0, &bz));
+    }
+    return hash;
+}
+
+// The ADXL345 data registers for a sample, as the I2C0 ISR receives them.
+static void
+toRegs (vector3_t v, uint8_t *bytes)
+{
+    bytes[0] = (uint16_t) v.x & 0xFF;
+    bytes[1] = (uint16_t) v.x >> 8;
+    bytes[2] = (uint16_t) v.y & 0xFF;
+    bytes[3] = (uint16_t) v.y >> 8;
+    bytes[4] = (uint16_t) v.z & 0xFF;
+    bytes[5] = (uint16_t) v.z >> 8;
+}
+
+// Drain path before in-place reads: bytes into a buffer, decoded and
+// pushed, popped into a batch, copied on into main()'s sample ring and
+// read back. The ring is a plain array here, as no firmware uses one now.
+static uint32_t
+runQueueCopy (const vector3_t *s, uint32_t n)
+{
+    static vector3_t ring[BENCH_BATCH];
+    vector3_t batch[ACCL_FIFO_BATCH];
+    uint8_t rx[6];
+    vector3_t v;
+    uint32_t hash = HASH_START;
+    uint32_t i;
+    uint16_t j, got, held;
+
+    copy_queue.head = copy_queue.tail = 0;
+    for (i = 0; i < n; i += BENCH_BATCH)
+    {
+        for (j = 0; j < BENCH_BATCH && i + j < n; j++)
+        {
+            toRegs (s[i + j], rx);
+            v.x = (rx[1] << 8) | rx[0];
+            v.y = (rx[3] << 8) | rx[2];
+            v.z = (rx[5] << 8) | rx[4];
+            spscPush (&copy_queue, &v);
+        }
+        held = 0;
+        while ((got = spscPopBatch (&copy_queue, batch, ACCL_FIFO_BATCH)) > 0)
+        {
+            memcpy (&ring[held], batch, got * sizeof (vector3_t));
+            held += got;
+        }
+        for (j = 0; j < held; j++)
+        {
+            v = ring[j];
+            hash = mix (hash, v.x + v.y + v.z);
+        }
+    }
+    return hash;
+}
+
+// In place: bytes land in a claimed queue slot and are used there.
+static uint32_t
+runQueueInPlace (const vector3_t *s, uint32_t n)
+{
+    const vector3_t *peeked;
+    uint32_t hash = HASH_START;
+    uint32_t i;
+    uint16_t j, got;
+
+    place_queue.head = place_queue.tail = 0;
+    for (i = 0; i < n; i += BENCH_BATCH)
+    {
+        for (j = 0; j < BENCH_BATCH && i + j < n; j++)
+        {
+            toRegs (s[i + j], (uint8_t *) spscClaim (&place_queue));
+            spscCommit (&place_queue);
+        }
+        while ((got = spscPeek (&place_queue, &peeked)) > 0)
+        {
+            for (j = 0; j < got; j++)
+                hash = mix (hash, peeked[j].x + peeked[j].y + peeked[j].z);
+            spscRelease (&place_queue, got);
+        }
+    }
+    return hash;
+}
+
+static uint32_t
+runMovingAvg (const vector3_t *s, uint32_t n)
+{
+    static int16_t window[3][BENCH_WINDOW];
+    movingAvg_t mx, my, mz;
+    uint32_t hash = HASH_START;
+    uint32_t i;
+
+    initMovingAvg (&mx, window[0], BENCH_WINDOW, BENCH_WINDOW);
+    initMovingAvg (&my, window[1], BENCH_WINDOW, BENCH_WINDOW);
+    initMovingAvg (&mz, window[2], BENCH_WINDOW, BENCH_WINDOW);
+    for (i = 0; i < n; i++)
+    {
+        updateMovingAvg (&mx, s[i].x);
+        updateMovingAvg (&my, s[i].y);
+        updateMovingAvg (&mz, s[i].z);
+        hash = mix (hash, getMovingAvg (&mx));
+        hash = mix (hash, getMovingAvg (&my));
+        hash = mix (hash, getMovingAvg (&mz));
+    }
+    return hash;
+}
+
+static uint32_t
+runPitchRoll (const vector3_t *s, uint32_t n)
+{
+    uint32_t hash = HASH_START;
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        hash = mix (hash, calcPitch (s[i], 0));
+        hash = mix (hash, calcRoll (s[i], 0));
+    }
+    return hash;
+}
+
+static uint32_t
+runStepDetect (const vector3_t *s, uint32_t n)
+{
+    stepDetect_t detector;
+    uint32_t hash = HASH_START;
+    uint32_t i;
+
+    initStepDetect (&detector);
+    for (i = 0; i < n; i++)
+        if (updateStepDetect (&detector, s[i]))
+            hash = mix (hash, i);
+    return mix (hash, getStepCount (&detector));
+}
+
+// Low-pass and decimate by 2, in FIFO sized batches.
+static uint32_t
+runFirDecimate (const vector3_t *s, uint32_t n)
+{
+    static firFilterV_t filter;
+    vector3_t out[BENCH_BATCH];
+    uint32_t hash = HASH_START;
+    uint32_t i;
+    uint16_t batch, made, j;
+
+    initFirV (&filter, fir_lowpass_16, FIR_LOWPASS_16_TAPS, 2);
+    for (i = 0; i < n; i += batch)
+    {
+        batch = (n - i < BENCH_BATCH) ? n - i : BENCH_BATCH;
+        made = firBlockV (&filter, &s[i], batch, out);
+        for (j = 0; j < made; j++)
+            hash = mix (hash, out[j].x + out[j].y + out[j].z);
+    }
+    return hash;
+}
+
+static const kernel_t kernels[] = {
+    {"circBufT x3", runCircBufT},
+    {"calcMean x3", runCalcMean},
+    {"queue copy", runQueueCopy},
+    {"queue inplace", runQueueInPlace},
+    {"movingAvg x3", runMovingAvg},
+    {"fir16 /2", runFirDecimate},
+    {"pitch+roll", runPitchRoll},
+    {"stepDetect", runStepDetect},
+};
+#define NUM_KERNELS (sizeof (kernels) / sizeof (kernels[0]))
+
+/*********************************************************
+ * Traces
+ *********************************************************/
+static bool
+loadTrace (const char *path)
+{
+    FILE *fp = fopen (path, "r");
+    char line[128];
+    int x, y, z;
+
+    if (fp == NULL)
+        return false;
+    num_samples = 0;
+    while (fgets (line, sizeof (line), fp) != NULL && num_samples < MAX_SAMPLES)
+    {
+        if (line[0] == '#' || sscanf (line, "%d,%d,%d", &x, &y, &z) != 3)
+            continue;
+        samples[num_samples].x = x;
+        samples[num_samples].y = y;
+        samples[num_samples].z = z;
+        num_samples++;
+    }
+    fclose (fp);
+    return num_samples > 0;
+}
+
+static void
+bench (const char *path)
+{
+    const char *name = strrchr (path, '/') ? strrchr (path, '/') + 1 : path;
+    uint64_t start, elapsed;
+    uint32_t rounds, checksum;
+    double ns;
+    uint8_t k;
+
+    for (k = 0; k < NUM_KERNELS; k++)
+    {
+        checksum = kernels[k].run (samples, num_samples);
+        rounds = 0;
+        start = wallNs ();
+        do
+        {
+            if (kernels[k].run (samples, num_samples) != checksum)
+                printf ("  (%s: output changed between runs)\n", kernels[k].name);
+            rounds++;
+            elapsed = wallNs () - start;
+        } while (elapsed < BENCH_MIN_NS);
+        ns = (double) elapsed / rounds / num_samples;
+        printf ("  %-12s %-13s %7u %8.2f %9.1f   %08x\n", name, kernels[k].name,
+                num_samples, ns, 1000.0 / ns, checksum);
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+    int arg;
+
+    printf ("  %-12s %-13s %7s %8s %9s   %-8s\n", "trace", "kernel",
+            "samples", "ns/samp", "Msamp/s", "checksum");
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (!loadTrace (argv[arg]))
+        {
+            fprintf (stderr, "bench: cannot read %s\n", argv[arg]);
+            return 1;
+        }
+        bench (argv[arg]);
+    }
+    return 0;
+}
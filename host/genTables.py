@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""
+genTables.py
+
+Generates ../Project/trigTables.c, the lookup tables behind the
+interpolated accessors in trigLut.c. The sizes and scalings must match
+trigLut.h. The host Makefile reruns this whenever it changes. The output
+is committed, so the CCS build does not need Python.
+
+    python3 genTables.py > ../Project/trigTables.c
+
+Ben Stewart and Daniel Pallesen
+11th of May 2022
+"""
+
+import math
+
+ATAN_LUT_BITS = 6           # 64 intervals of the ratio over [0, 1]
+ATAN_LUT_FRAC = 3           # centidegrees << 3
+INVSQRT_LUT_BITS = 5        # 32 intervals per unit over [1, 4]
+INVSQRT_LUT_ONE = 1 << 15   # Q15
+
+
+def atan_table():
+    n = 1 << ATAN_LUT_BITS
+    return [round(math.degrees(math.atan(i / n)) * 100 * (1 << ATAN_LUT_FRAC))
+            for i in range(n + 1)]
+
+
+def invsqrt_table():
+    step = 1 << INVSQRT_LUT_BITS
+    return [round(INVSQRT_LUT_ONE / math.sqrt(j / step))
+            for j in range(step, 4 * step + 1)]
+
+
+def emit(name, values, comment):
+    print("// " + comment)
+    print("const uint16_t %s[%d] = {" % (name, len(values)))
+    for i in range(0, len(values), 8):
+        print("    " + ", ".join("%5d" % v for v in values[i:i + 8]) + ",")
+    print("};")
+
+
+if __name__ == "__main__":
+    print("""/**********************************************************
+ *
+ * trigTables.c
+ *
+ * GENERATED by host/genTables.py, do not edit. Lookup tables
+ * for trigLut.c, placed in flash (.const).
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include "trigLut.h"
+""")
+    emit("atan_lut", atan_table(),
+         "atan(i / %d) in centidegrees << %d, i = 0..%d"
+         % (1 << ATAN_LUT_BITS, ATAN_LUT_FRAC, 1 << ATAN_LUT_BITS))
+    print()
+    emit("invsqrt_lut", invsqrt_table(),
+         "2^15 / sqrt(j / %d), j = %d..%d"
+         % (1 << INVSQRT_LUT_BITS, 1 << INVSQRT_LUT_BITS,
+            4 << INVSQRT_LUT_BITS))
@@ -0,0 +1,227 @@
+/**********************************************************
+ *
+ * gravityReport.c
+ *
+ * Noise and cost of the displayed pitch and roll, two ways:
+ *
+ *  - "sample": pitchCentideg()/rollCentideg() of the newest
+ *    raw sample at each display update, as main() did with
+ *    calcPitch()/calcRoll(); and
+ *  - "gravity": gravityPitch()/gravityRoll() of the
+ *    complementary estimate in gravityFilter.c, updated on
+ *    every sample.
+ *
+ * Angles are read every DISPLAY_EVERY samples (the 4 Hz
+ * display at 100 Hz). Each is compared with the double
+ * precision angle of the mean of the REF_HALF samples
+ * either side, taken as the true tilt. 'rms' and 'max' are
+ * the error against it. 'jitter' is the RMS change between
+ * updates, and 'flips' counts updates on which the shown
+ * whole degree changed. All are in centidegrees.
+ *
+ *     make gravity-report
+ *     ./build/gravityReport traces/walking.csv ...
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "orientFixed.h"
+#include "gravityFilter.h"
+
+#define MAX_SAMPLES     200000
+#define DISPLAY_EVERY   25
+#define REF_HALF        100
+#define TIMING_ROUNDS   200
+#define DEG_TO_CENTIDEG (18000.0 / M_PI)
+
+typedef struct {
+    uint32_t count;
+    double sum_sq_err;
+    double max_err;
+    double sum_sq_jump;
+    uint32_t flips;
+    int16_t last;
+} stats_t;
+
+static vector3_t samples[MAX_SAMPLES];
+static uint32_t num_samples;
+
+static uint64_t
+wallNs (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static bool
+loadTrace (const char *path)
+{
+    FILE *fp = fopen (path, "r");
+    char line[128];
+    int x, y, z;
+
+    if (fp == NULL)
+    {
+        fprintf (stderr, "gravityReport: cannot read %s\n", path);
+        return false;
+    }
+    num_samples = 0;
+    while (fgets (line, sizeof (line), fp) != NULL && num_samples < MAX_SAMPLES)
+        if (line[0] != '#' && sscanf (line, "%d,%d,%d", &x, &y, &z) == 3)
+        {
+            samples[num_samples].x = x;
+            samples[num_samples].y = y;
+            samples[num_samples].z = z;
+            num_samples++;
+        }
+    fclose (fp);
+    return num_samples > 2 * REF_HALF;
+}
+
+// True pitch and roll at sample i, from the centred mean.
+static void
+reference (uint32_t i, double *pitch, double *roll)
+{
+    double x = 0, y = 0, z = 0;
+    uint32_t j;
+
+    for (j = i - REF_HALF; j <= i + REF_HALF; j++)
+    {
+        x += samples[j].x;
+        y += samples[j].y;
+        z += samples[j].z;
+    }
+    *pitch = atan2 (y, sqrt (x * x + z * z)) * DEG_TO_CENTIDEG;
+    *roll = atan2 (-x, z) * DEG_TO_CENTIDEG;
+}
+
+static void
+account (stats_t *s, int16_t angle, double exact)
+{
+    double err = fabs (angle - exact);
+
+    if (s->count > 0)
+    {
+        s->sum_sq_jump += (double) (angle - s->last) * (angle - s->last);
+        if (centidegToDeg (angle) != centidegToDeg (s->last))
+            s->flips++;
+    }
+    s->sum_sq_err += err * err;
+    if (err > s->max_err)
+        s->max_err = err;
+    s->last = angle;
+    s->count++;
+}
+
+static void
+printStats (const char *trace, const char *method, const char *angle,
+            const stats_t *s)
+{
+    printf ("  %-12s %-8s %-5s %6u %7.1f %7.1f %7.1f %6u\n", trace, method,
+            angle, s->count, sqrt (s->sum_sq_err / s->count), s->max_err,
+            s->count > 1 ? sqrt (s->sum_sq_jump / (s->count - 1)) : 0.0,
+            s->flips);
+}
+
+static void
+report (const char *trace)
+{
+    stats_t sample_pitch = {0}, sample_roll = {0};
+    stats_t grav_pitch = {0}, grav_roll = {0};
+    gravityFilter_t filter;
+    double pitch, roll;
+    uint32_t i;
+
+    initGravityFilter (&filter);
+    for (i = 0; i + REF_HALF < num_samples; i++)
+    {
+        updateGravityFilter (&filter, samples[i]);
+        if (i < REF_HALF || i % DISPLAY_EVERY != 0)
+            continue;
+        reference (i, &pitch, &roll);
+        account (&sample_pitch, pitchCentideg (samples[i]), pitch);
+        account (&sample_roll, rollCentideg (samples[i]), roll);
+        account (&grav_pitch, gravityPitch (&filter), pitch);
+        account (&grav_roll, gravityRoll (&filter), roll);
+    }
+    printStats (trace, "sample", "pitch", &sample_pitch);
+    printStats (trace, "sample", "roll", &sample_roll);
+    printStats (trace, "gravity", "pitch", &grav_pitch);
+    printStats (trace, "gravity", "roll", &grav_roll);
+}
+
+/*********************************************************
+ * timing: ns per sample for each way, with angles read at
+ * the display rate, and for angles on every sample as a
+ * bound.
+ *********************************************************/
+static void
+timing (void)
+{
+    volatile int32_t sink = 0;
+    gravityFilter_t filter;
+    uint64_t start;
+    double sample_ns, every_ns, grav_ns;
+    uint32_t round, i;
+
+    start = wallNs ();
+    for (round = 0; round < TIMING_ROUNDS; round++)
+        for (i = 0; i < num_samples; i += DISPLAY_EVERY)
+            sink += pitchCentideg (samples[i]) + rollCentideg (samples[i]);
+    sample_ns = (double) (wallNs () - start) / TIMING_ROUNDS / num_samples;
+
+    start = wallNs ();
+    for (round = 0; round < TIMING_ROUNDS; round++)
+        for (i = 0; i < num_samples; i++)
+            sink += pitchCentideg (samples[i]) + rollCentideg (samples[i]);
+    every_ns = (double) (wallNs () - start) / TIMING_ROUNDS / num_samples;
+
+    start = wallNs ();
+    for (round = 0; round < TIMING_ROUNDS; round++)
+    {
+        initGravityFilter (&filter);
+        for (i = 0; i < num_samples; i++)
+        {
+            updateGravityFilter (&filter, samples[i]);
+            if (i % DISPLAY_EVERY == 0)
+                sink += gravityPitch (&filter) + gravityRoll (&filter);
+        }
+    }
+    grav_ns = (double) (wallNs () - start) / TIMING_ROUNDS / num_samples;
+
+    printf ("\nhost ns per sample (last trace): sample %.1f, gravity %.1f;"
+            " pitch+roll on every sample %.1f\n", sample_ns, grav_ns, every_ns);
+}
+
+int
+main (int argc, char **argv)
+{
+    char name[16];
+    const char *base;
+    int arg;
+
+    printf ("displayed pitch/roll against the %d-sample centred mean,"
+            " centidegrees\n  %-12s %-8s %-5s %6s %7s %7s %7s %6s\n",
+            2 * REF_HALF + 1, "trace", "method", "angle", "reads", "rms", "max",
+            "jitter", "flips");
+    for (arg = 1; arg < argc; arg++)
+        if (loadTrace (argv[arg]))
+        {
+            base = strrchr (argv[arg], '/');
+            snprintf (name, sizeof (name), "%.12s", base ? base + 1 : argv[arg]);
+            report (name);
+        }
+    if (num_samples > 0)
+        timing ();
+    return 0;
+}
@@ -0,0 +1,464 @@
+/**********************************************************
+ *
+ * hostAdxl345.c
+ *
+ * Register level model of the ADXL345 on the Orbit
+ * BoosterPack, attached to the host I2C0 model at ACCL_ADDR.
+ *
+ * While measuring, a new trace sample is converted at the
+ * BW_RATE output rate. In bypass mode DATAX0..DATAZ1 always
+ * show the newest sample, and OVERRUN is set if one is
+ * replaced before it was read; in FIFO and stream modes samples
+ * queue in a 32 entry FIFO and each read of the data
+ * registers pops one. The DATA_READY, WATERMARK and OVERRUN
+ * interrupts drive INT1 (PB4) or INT2 (PE4) as mapped by
+ * INT_MAP.
+ *
+ * Activity and inactivity are detected, DC or AC coupled,
+ * on each conversion. With LINK set they alternate, and with
+ * AUTO_SLEEP the part also sleeps on inactivity, converting
+ * at the wake-up rate until activity. Time in each power
+ * mode is charged at the datasheet's typical currents
+ * (2.5 V) for the power report.
+ *
+ * Each trace sample is read as the part would measure it:
+ * plus the zero-g bias given by HOST_ACCL_BIAS, plus the
+ * OFSX..OFSZ registers at 15.6 mg per LSB.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    8th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+#include "acc.h"
+#include "hostHal.h"
+
+#define NUM_REGS        0x3A
+#define REG_DEVID       0x00
+#define DEVID_ADXL345   0xE5
+#define DATA_Y0         0x34
+#define DATA_Y1         0x35
+#define DATA_Z0         0x36
+#define DATA_Z1         0x37
+#define FIFO_MODE_M     0xC0
+#define WAKEUP_M        0x03
+#define COUNTS_PER_THRESH 16    // 62.5 mg at 3.9 mg/LSB
+#define STANDBY_UA      0.1
+#define ASLEEP_UA       23.0
+
+// Typical supply current in uA by BW_RATE rate code, normal and LOW_POWER.
+static const float rate_ua[16] = {
+    23, 23, 23, 23, 34, 40, 45, 50, 60, 90, 140, 140, 140, 140, 90, 140
+};
+static const float low_power_ua[16] = {
+    23, 23, 23, 23, 34, 40, 45, 34, 40, 45, 50, 60, 90, 140, 90, 140
+};
+
+enum powerModes {MODE_STANDBY = 0, MODE_NORMAL, MODE_LOW_POWER, MODE_ASLEEP,
+                 NUM_MODES};
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static uint8_t regs[NUM_REGS];
+static uint8_t reg_ptr;
+static bool ptr_pending;        // next written byte is the register pointer
+
+static hostSample_t fifo[ACCL_FIFO_DEPTH];
+static uint8_t fifo_head;
+static uint8_t fifo_count;
+static hostSample_t output;     // DATAX0..DATAZ1 contents
+static bool output_fresh;       // output not yet read (DATA_READY)
+
+static bool inactive;           // Inactivity seen last (LINK)
+static bool asleep;             // Auto-sleep
+static hostSample_t act_ref;    // AC reference for activity
+static hostSample_t inact_ref;  // AC reference for inactivity
+static uint64_t inact_since;    // Start of the current still period
+
+static hostSample_t bias;       // HOST_ACCL_BIAS
+
+static uint64_t mode_since;
+static uint64_t mode_cycles[NUM_MODES];
+static double charge;           // uA x cycles
+
+static uint32_t stat_conversions;
+static uint32_t stat_overruns;
+static uint32_t stat_activity;
+static uint32_t stat_inactivity;
+
+static void convert (void);
+static hostEvent_t convert_event = {0, false, convert};
+
+/*********************************************************
+ * Interrupt sources and pins
+ *********************************************************/
+static void
+updateIntSource (void)
+{
+    uint8_t source = regs[ACCL_INT_SOURCE]
+        & ~(ACCL_INT_DATA_READY | ACCL_INT_WATERMARK);
+    uint8_t active;
+    bool invert = (regs[ACCL_DATA_FORMAT] & ACCL_INT_INVERT) != 0;
+
+    if (output_fresh || fifo_count > 0)
+        source |= ACCL_INT_DATA_READY;
+    if ((regs[ACCL_FIFO_CTL] & FIFO_MODE_M) != ACCL_FIFO_BYPASS
+        && fifo_count >= (regs[ACCL_FIFO_CTL] & ACCL_FIFO_SAMPLES))
+        source |= ACCL_INT_WATERMARK;
+    regs[ACCL_INT_SOURCE] = source;
+
+    active = source & regs[ACCL_INT];
+    hostGpioDrive (GPIO_PORTB_BASE, GPIO_PIN_4,
+                   ((active & ~regs[ACCL_INT_MAP]) != 0) != invert
+                   ? GPIO_PIN_4 : 0);
+    hostGpioDrive (GPIO_PORTE_BASE, GPIO_PIN_4,
+                   ((active & regs[ACCL_INT_MAP]) != 0) != invert
+                   ? GPIO_PIN_4 : 0);
+}
+
+/*********************************************************
+ * Power accounting: call before anything that changes the
+ * power mode.
+ *********************************************************/
+static uint8_t
+powerMode (void)
+{
+    if (!(regs[ACCL_PWR_CTL] & ACCL_MEASURE))
+        return MODE_STANDBY;
+    if (asleep)
+        return MODE_ASLEEP;
+    return (regs[ACCL_BW_RATE] & ACCL_LOW_POWER) ? MODE_LOW_POWER : MODE_NORMAL;
+}
+
+static void
+accountPower (void)
+{
+    uint8_t rate = regs[ACCL_BW_RATE] & 0x0F;
+    uint8_t mode = powerMode ();
+    uint64_t cycles = hostNow () - mode_since;
+    double ua = STANDBY_UA;
+
+    if (mode == MODE_ASLEEP)
+        ua = ASLEEP_UA;
+    else if (mode == MODE_LOW_POWER)
+        ua = low_power_ua[rate];
+    else if (mode == MODE_NORMAL)
+        ua = rate_ua[rate];
+    mode_cycles[mode] += cycles;
+    charge += ua * cycles;
+    mode_since = hostNow ();
+}
+
+/*********************************************************
+ * Activity and inactivity
+ *********************************************************/
+static bool
+axisBeyond (int16_t value, int16_t ref, bool ac, uint16_t threshold)
+{
+    int32_t delta = ac ? value - ref : value;
+
+    return delta > threshold || -delta > threshold;
+}
+
+// Whether any enabled axis is beyond the threshold; axes are X, Y, Z from
+// bit 2 of the three bit group.
+static bool
+anyBeyond (const hostSample_t *s, const hostSample_t *ref, uint8_t axes,
+           bool ac, uint16_t threshold)
+{
+    return ((axes & 4) && axisBeyond (s->x, ref->x, ac, threshold))
+        || ((axes & 2) && axisBeyond (s->y, ref->y, ac, threshold))
+        || ((axes & 1) && axisBeyond (s->z, ref->z, ac, threshold));
+}
+
+static void
+startActivity (const hostSample_t *s)
+{
+    inact_ref = *s;
+    inact_since = hostNow ();
+    act_ref = *s;
+}
+
+static void
+detectActivity (const hostSample_t *s)
+{
+    uint8_t ctl = regs[ACCL_ACT_INACT_CTL];
+    bool link = (regs[ACCL_PWR_CTL] & ACCL_LINK) != 0;
+    uint16_t act_thresh = regs[ACCL_THRESH_ACT] * COUNTS_PER_THRESH;
+    uint16_t inact_thresh = regs[ACCL_THRESH_INACT] * COUNTS_PER_THRESH;
+    uint64_t inact_time = (uint64_t) regs[ACCL_TIME_INACT] * hostClockHz ();
+
+    if ((!link || inactive) && (ctl & 0x70) && act_thresh > 0
+        && anyBeyond (s, &act_ref, (ctl >> 4) & 7, ctl & ACCL_ACT_AC,
+                      act_thresh))
+    {
+        stat_activity++;
+        regs[ACCL_INT_SOURCE] |= ACCL_INT_ACTIVITY;
+        accountPower ();
+        inactive = false;
+        asleep = false;
+        startActivity (s);
+    }
+    else if ((!link || !inactive) && (ctl & 0x07))
+    {
+        if (anyBeyond (s, &inact_ref, ctl & 7, ctl & ACCL_INACT_AC,
+                       inact_thresh))
+        {
+            // Still period broken; it restarts from here.
+            inact_ref = *s;
+            inact_since = hostNow ();
+        }
+        else if (hostNow () - inact_since >= inact_time)
+        {
+            stat_inactivity++;
+            regs[ACCL_INT_SOURCE] |= ACCL_INT_INACTIVITY;
+            accountPower ();
+            inactive = true;
+            asleep = link && (regs[ACCL_PWR_CTL] & ACCL_AUTO_SLEEP);
+            act_ref = *s;
+            inact_ref = *s;
+            inact_since = hostNow ();
+        }
+    }
+}
+
+/*********************************************************
+ * Conversions at the output data rate, or the wake-up rate
+ * while asleep
+ *********************************************************/
+static uint64_t
+conversionPeriod (void)
+{
+    uint8_t rate = regs[ACCL_BW_RATE] & 0x0F;
+
+    if (asleep)
+        return hostClockHz () / (8 >> (regs[ACCL_PWR_CTL] & WAKEUP_M));
+    // 3200 Hz at code 0xF, halving with each step down.
+    return ((uint64_t) hostClockHz () << (0x0F - rate)) / 3200;
+}
+
+/*********************************************************
+ * measure: a trace sample as the part outputs it, with its
+ * zero-g bias and the offset registers added. An offset LSB
+ * is 4 LSBs in full resolution or at +-2 g, less at higher
+ * ranges.
+ *********************************************************/
+static hostSample_t
+measure (const hostSample_t *s)
+{
+    hostSample_t m = *s;
+    uint8_t shift = 0;
+
+    if (!(regs[ACCL_DATA_FORMAT] & ACCL_FULL_RES))
+        shift = regs[ACCL_DATA_FORMAT] & 0x03;
+    m.x += bias.x + ((int8_t) regs[ACCL_OFFSET_X] * 4 >> shift);
+    m.y += bias.y + ((int8_t) regs[ACCL_OFFSET_Y] * 4 >> shift);
+    m.z += bias.z + ((int8_t) regs[ACCL_OFFSET_Z] * 4 >> shift);
+    return m;
+}
+
+static void
+convert (void)
+{
+    hostSample_t measured = measure (hostTraceAt (hostTraceIndexNow ()));
+    const hostSample_t *s = &measured;
+    uint8_t mode = regs[ACCL_FIFO_CTL] & FIFO_MODE_M;
+
+    if (!(regs[ACCL_PWR_CTL] & ACCL_MEASURE))
+    {
+        hostEventArm (&convert_event, hostNow () + conversionPeriod ());
+        return;
+    }
+    detectActivity (s);
+    hostEventArm (&convert_event, hostNow () + conversionPeriod ());
+
+    stat_conversions++;
+    if (mode == ACCL_FIFO_BYPASS)
+    {
+        if (output_fresh)
+        {
+            // The last conversion was never read.
+            stat_overruns++;
+            regs[ACCL_INT_SOURCE] |= ACCL_INT_OVERRUN;
+        }
+        output = *s;
+        output_fresh = true;
+    }
+    else if (fifo_count < ACCL_FIFO_DEPTH)
+    {
+        fifo[(fifo_head + fifo_count) % ACCL_FIFO_DEPTH] = *s;
+        fifo_count++;
+    }
+    else
+    {
+        stat_overruns++;
+        regs[ACCL_INT_SOURCE] |= ACCL_INT_OVERRUN;
+        if (mode == ACCL_FIFO_STREAM || mode == ACCL_FIFO_TRIGGER)
+        {
+            // Oldest sample is overwritten.
+            fifo[fifo_head] = *s;
+            fifo_head = (fifo_head + 1) % ACCL_FIFO_DEPTH;
+        }
+    }
+    updateIntSource ();
+}
+
+/*********************************************************
+ * latchOutput: start of a read of the data registers. A
+ * FIFO entry moves into the output registers.
+ *********************************************************/
+static void
+latchOutput (void)
+{
+    if ((regs[ACCL_FIFO_CTL] & FIFO_MODE_M) != ACCL_FIFO_BYPASS)
+    {
+        if (fifo_count > 0)
+        {
+            output = fifo[fifo_head];
+            fifo_head = (fifo_head + 1) % ACCL_FIFO_DEPTH;
+            fifo_count--;
+        }
+        regs[ACCL_INT_SOURCE] &= ~ACCL_INT_OVERRUN;
+    }
+    else
+    {
+        if (!(regs[ACCL_PWR_CTL] & ACCL_MEASURE) || !convert_event.armed)
+            output = measure (hostTraceAt (hostTraceIndexNow ()));
+        regs[ACCL_INT_SOURCE] &= ~ACCL_INT_OVERRUN;
+    }
+    output_fresh = false;
+
+    regs[ACCL_DATA_X0] = (uint8_t) output.x;
+    regs[ACCL_DATA_X1] = (uint8_t) ((uint16_t) output.x >> 8);
+    regs[DATA_Y0] = (uint8_t) output.y;
+    regs[DATA_Y1] = (uint8_t) ((uint16_t) output.y >> 8);
+    regs[DATA_Z0] = (uint8_t) output.z;
+    regs[DATA_Z1] = (uint8_t) ((uint16_t) output.z >> 8);
+    updateIntSource ();
+}
+
+/*********************************************************
+ * I2C device interface
+ *********************************************************/
+static bool
+adxlStart (bool read)
+{
+    ptr_pending = !read;
+    if (read && reg_ptr >= ACCL_DATA_X0 && reg_ptr <= DATA_Z1)
+        latchOutput ();
+    return true;
+}
+
+static void
+adxlWrite (uint8_t byte)
+{
+    if (ptr_pending)
+    {
+        reg_ptr = byte;
+        ptr_pending = false;
+        return;
+    }
+    if (reg_ptr < NUM_REGS && reg_ptr != REG_DEVID
+        && reg_ptr != ACCL_INT_SOURCE && reg_ptr != ACCL_FIFO_STATUS)
+    {
+        if (reg_ptr == ACCL_BW_RATE || reg_ptr == ACCL_PWR_CTL)
+            accountPower ();
+        if (reg_ptr == ACCL_PWR_CTL && (byte & ACCL_MEASURE)
+            && !(regs[ACCL_PWR_CTL] & ACCL_MEASURE))
+        {
+            // Entering measurement: detection starts afresh.
+            inactive = false;
+            asleep = false;
+            startActivity (hostTraceAt (hostTraceIndexNow ()));
+        }
+        regs[reg_ptr] = byte;
+        if (reg_ptr == ACCL_FIFO_CTL && (byte & FIFO_MODE_M) == ACCL_FIFO_BYPASS)
+            fifo_count = 0;
+        if (reg_ptr == ACCL_BW_RATE || reg_ptr == ACCL_PWR_CTL)
+            hostEventArm (&convert_event, hostNow () + conversionPeriod ());
+        updateIntSource ();
+    }
+    reg_ptr++;
+}
+
+static uint8_t
+adxlRead (void)
+{
+    uint8_t byte = 0;
+
+    if (reg_ptr == ACCL_FIFO_STATUS)
+        regs[ACCL_FIFO_STATUS] = fifo_count + (output_fresh ? 1 : 0);
+    if (reg_ptr < NUM_REGS)
+        byte = regs[reg_ptr];
+    if (reg_ptr == ACCL_INT_SOURCE)
+    {
+        // Event sources clear on read; the data sources follow the FIFO.
+        regs[ACCL_INT_SOURCE] &= ACCL_INT_DATA_READY | ACCL_INT_WATERMARK
+                               | ACCL_INT_OVERRUN;
+        updateIntSource ();
+    }
+    reg_ptr++;
+    return byte;
+}
+
+static void
+adxlStop (void)
+{
+}
+
+static const hostI2cDevice_t adxl345 = {
+    ACCL_ADDR, adxlStart, adxlWrite, adxlRead, adxlStop
+};
+
+void
+hostAdxl345Attach (void)
+{
+    const char *env = getenv ("HOST_ACCL_BIAS");
+    int x, y, z;
+
+    regs[REG_DEVID] = DEVID_ADXL345;
+    regs[ACCL_BW_RATE] = ACCL_RATE_100HZ;
+    if (env != NULL && sscanf (env, "%d,%d,%d", &x, &y, &z) == 3)
+    {
+        bias.x = x;
+        bias.y = y;
+        bias.z = z;
+    }
+    hostI2cAttach (&adxl345);
+}
+
+double
+hostAdxl345AverageUa (void)
+{
+    accountPower ();
+    return hostNow () ? charge / hostNow () : 0.0;
+}
+
+void
+hostAdxl345Report (void)
+{
+    double total;
+
+    accountPower ();
+    total = hostNow () ? (double) hostNow () : 1.0;
+    printf ("host: adxl345 %u conversions, %u overruns,"
+            " %u activity, %u inactivity\n", stat_conversions, stat_overruns,
+            stat_activity, stat_inactivity);
+    printf ("host: adxl345 normal %.1f%%, low-power %.1f%%, asleep %.1f%%,"
+            " standby %.1f%%\n", 100.0 * mode_cycles[MODE_NORMAL] / total,
+            100.0 * mode_cycles[MODE_LOW_POWER] / total,
+            100.0 * mode_cycles[MODE_ASLEEP] / total,
+            100.0 * mode_cycles[MODE_STANDBY] / total);
+    if (regs[ACCL_OFFSET_X] || regs[ACCL_OFFSET_Y] || regs[ACCL_OFFSET_Z]
+        || bias.x || bias.y || bias.z)
+        printf ("host: adxl345 bias %d,%d,%d, offset registers %d,%d,%d\n",
+                bias.x, bias.y, bias.z, (int8_t) regs[ACCL_OFFSET_X],
+                (int8_t) regs[ACCL_OFFSET_Y], (int8_t) regs[ACCL_OFFSET_Z]);
+}
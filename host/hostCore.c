@@ -0,0 +1,189 @@
+/**********************************************************
+ *
+ * hostCore.c
+ *
+ * Virtual clock, emulated register map and end of run
+ * report for the host build of the pedometer firmware.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    8th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hostHal.h"
+#include "hostFlash.h"
+#include "profile.h"
+#include "scheduler.h"
+#include "readAcc.h"
+#include "stepLog.h"
+
+#define HOST_NUM_REGS 128
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static uint64_t now_cycles;
+
+static struct {
+    uint32_t addr;
+    uint32_t value;
+} regs[HOST_NUM_REGS];
+static uint16_t num_regs;
+
+static uint64_t run_start_ns;
+static uint64_t last_mark_ns;
+static uint32_t loop_count;
+static uint64_t loop_total_ns;
+static uint64_t loop_min_ns = UINT64_MAX;
+static uint64_t loop_max_ns;
+
+/*********************************************************
+ * hostInit: brings up the peripheral models before main().
+ *********************************************************/
+static void __attribute__ ((constructor))
+hostInit (void)
+{
+    hostTraceLoad ();
+    hostGpioInit ();
+    hostAdxl345Attach ();
+    hostFlashLoad ();
+    hostEepromLoad ();
+}
+
+/*********************************************************
+ * Virtual clock
+ *********************************************************/
+uint64_t
+hostNow (void)
+{
+    return now_cycles;
+}
+
+// Only hostNvic.c moves the clock, so that events are fired on the way.
+void
+hostSetNow (uint64_t cycles)
+{
+    if (cycles > now_cycles)
+        now_cycles = cycles;
+}
+
+double
+hostSeconds (void)
+{
+    return (double) now_cycles / hostClockHz ();
+}
+
+uint64_t
+hostWallNs (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/*********************************************************
+ * hostReg: returns the backing store for a memory mapped
+ * register, creating it (reset value 0) on first use.
+ *********************************************************/
+volatile uint32_t *
+hostReg (uint32_t addr)
+{
+    uint16_t i;
+
+    for (i = 0; i < num_regs; i++)
+        if (regs[i].addr == addr)
+            return &regs[i].value;
+
+    if (num_regs >= HOST_NUM_REGS)
+    {
+        fprintf (stderr, "host: register map full at 0x%08x\n", addr);
+        exit (2);
+    }
+    regs[num_regs].addr = addr;
+    regs[num_regs].value = 0;
+    return &regs[num_regs++].value;
+}
+
+/*********************************************************
+ * hostLoopMark: called once per firmware loop iteration.
+ *********************************************************/
+void
+hostLoopMark (void)
+{
+    uint64_t wall = hostWallNs ();
+    uint64_t cost;
+
+    if (run_start_ns == 0)
+        run_start_ns = wall;
+
+    if (last_mark_ns != 0)
+    {
+        cost = wall - last_mark_ns;
+        loop_count++;
+        loop_total_ns += cost;
+        if (cost < loop_min_ns)
+            loop_min_ns = cost;
+        if (cost > loop_max_ns)
+            loop_max_ns = cost;
+    }
+
+    if (hostTraceFinished ())
+        hostFinish ();
+
+    last_mark_ns = hostWallNs ();
+}
+
+static void
+printFirmwareLine (const char *line)
+{
+    printf ("host: %s\n", line);
+}
+
+/*********************************************************
+ * hostFinish: end of run report.
+ *********************************************************/
+void
+hostFinish (void)
+{
+    double wall_s = (hostWallNs () - run_start_ns) / 1e9;
+
+    if (getenv ("HOST_QUIET") == NULL)
+    {
+        printf ("host: trace %s, %u samples at %u Hz\n", hostTraceName (),
+                hostTraceLength (), hostTraceRateHz ());
+        printf ("host: %.2f s virtual in %.4f s wall (%.0fx real time)\n",
+                hostSeconds (), wall_s,
+                wall_s > 0 ? hostSeconds () / wall_s : 0.0);
+        if (loop_count > 0)
+            printf ("host: %u loop iterations, ns per iteration"
+                    " min %llu mean %llu max %llu\n", loop_count,
+                    (unsigned long long) loop_min_ns,
+                    (unsigned long long) (loop_total_ns / loop_count),
+                    (unsigned long long) loop_max_ns);
+        hostSysTickReport ();
+        hostTimerReport ();
+        hostI2cReport ();
+        hostUartReport ();
+        hostAdxl345Report ();
+        hostOledReport ();
+        hostFlashReport ();
+        hostEepromReport ();
+        hostPowerReport ();
+        printf ("host: accl %u samples missed, %u dropped with the queue full\n",
+                acclMissedSamples (), acclQueueOverflows ());
+        printf ("host: step log %u steps over %u s\n", stepLogSteps (),
+                stepLogSeconds ());
+        schedDump (printFirmwareLine);
+        profileDump (printFirmwareLine);
+    }
+    hostFlashSave ();
+    hostEepromSave ();
+    fflush (stdout);
+    exit (0);
+}
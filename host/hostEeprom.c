@@ -0,0 +1,112 @@
+/**********************************************************
+ *
+ * hostEeprom.c
+ *
+ * Model of the TM4C123's 2 KB EEPROM. It reads back 0xFF
+ * until written. Reads and writes are whole words at word
+ * aligned addresses, as on the part.
+ *
+ * HOST_EEPROM names a file the EEPROM is loaded from at
+ * start up and saved to at the end of a run, as HOST_FLASH
+ * does for the flash.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "driverlib/eeprom.h"
+#include "hostHal.h"
+
+#define EEPROM_SIZE     2048
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static uint32_t eeprom[EEPROM_SIZE / 4];
+static bool initialised;
+static uint32_t stat_words;
+
+static void
+checkAccess (uint32_t addr, uint32_t count)
+{
+    if (!initialised || (addr & 3) || (count & 3) || addr + count > EEPROM_SIZE)
+    {
+        fprintf (stderr, "host: bad EEPROM access at 0x%03x, %u bytes%s\n",
+                 addr, count, initialised ? "" : " before EEPROMInit");
+        exit (2);
+    }
+}
+
+/*********************************************************
+ * hostEepromLoad, hostEepromSave: HOST_EEPROM persistence.
+ *********************************************************/
+void
+hostEepromLoad (void)
+{
+    const char *path = getenv ("HOST_EEPROM");
+    FILE *fp;
+
+    memset (eeprom, 0xFF, sizeof (eeprom));
+    if (path == NULL || (fp = fopen (path, "rb")) == NULL)
+        return;
+    if (fread (eeprom, 1, sizeof (eeprom), fp) != sizeof (eeprom))
+        memset (eeprom, 0xFF, sizeof (eeprom));
+    fclose (fp);
+}
+
+void
+hostEepromSave (void)
+{
+    const char *path = getenv ("HOST_EEPROM");
+    FILE *fp;
+
+    if (path == NULL || (fp = fopen (path, "wb")) == NULL)
+        return;
+    fwrite (eeprom, 1, sizeof (eeprom), fp);
+    fclose (fp);
+}
+
+void
+hostEepromReport (void)
+{
+    if (stat_words > 0)
+        printf ("host: eeprom %u words programmed\n", stat_words);
+}
+
+/*********************************************************
+ * driverlib EEPROM API
+ *********************************************************/
+uint32_t
+EEPROMInit (void)
+{
+    initialised = true;
+    return EEPROM_INIT_OK;
+}
+
+uint32_t
+EEPROMSizeGet (void)
+{
+    return EEPROM_SIZE;
+}
+
+void
+EEPROMRead (uint32_t *pui32Data, uint32_t ui32Address, uint32_t ui32Count)
+{
+    checkAccess (ui32Address, ui32Count);
+    memcpy (pui32Data, &eeprom[ui32Address / 4], ui32Count);
+}
+
+uint32_t
+EEPROMProgram (uint32_t *pui32Data, uint32_t ui32Address, uint32_t ui32Count)
+{
+    checkAccess (ui32Address, ui32Count);
+    memcpy (&eeprom[ui32Address / 4], pui32Data, ui32Count);
+    stat_words += ui32Count / 4;
+    return 0;
+}
@@ -0,0 +1,183 @@
+/**********************************************************
+ *
+ * hostFlash.c
+ *
+ * RAM backed model of the TM4C123's 256 KB internal flash.
+ * Erase works on 1 KB sectors and sets them to 0xFF.
+ * Programming works a word at a time and can only clear
+ * bits, as on the part.
+ *
+ * HOST_FLASH names a file the flash is loaded from at start
+ * up and saved to at the end of a run. Successive runs then
+ * behave like resets of the same board.
+ *
+ * For recovery tests, hostFlashCutAfter() stops all erases
+ * and programming after a given number of words, as a power
+ * cut would.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    9th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "driverlib/flash.h"
+#include "hostFlash.h"
+
+#define FLASH_SIZE      0x40000
+#define SECTOR_SIZE     1024
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static uint32_t flash[FLASH_SIZE / 4];
+static bool loaded;
+static bool powered = true;
+static bool cut_armed;
+static uint32_t cut_words;
+static hostFlashStats_t stats;
+
+static void
+eraseAll (void)
+{
+    memset (flash, 0xFF, sizeof (flash));
+    loaded = true;
+}
+
+/*********************************************************
+ * hostFlashLoad, hostFlashSave: HOST_FLASH persistence.
+ *********************************************************/
+void
+hostFlashLoad (void)
+{
+    const char *path = getenv ("HOST_FLASH");
+    FILE *fp;
+
+    eraseAll ();
+    if (path == NULL || (fp = fopen (path, "rb")) == NULL)
+        return;
+    if (fread (flash, 1, sizeof (flash), fp) != sizeof (flash))
+        eraseAll ();            // Short or foreign file, start blank
+    fclose (fp);
+}
+
+void
+hostFlashSave (void)
+{
+    const char *path = getenv ("HOST_FLASH");
+    FILE *fp;
+
+    if (path == NULL || (fp = fopen (path, "wb")) == NULL)
+        return;
+    fwrite (flash, 1, sizeof (flash), fp);
+    fclose (fp);
+}
+
+void
+hostFlashReport (void)
+{
+    if (stats.erases > 0 || stats.words > 0)
+        printf ("host: flash %u sector erases, %u words programmed\n",
+                stats.erases, stats.words);
+}
+
+/*********************************************************
+ * Test hooks
+ *********************************************************/
+void
+hostFlashReset (void)
+{
+    eraseAll ();
+    powered = true;
+    cut_armed = false;
+    memset (&stats, 0, sizeof (stats));
+}
+
+void
+hostFlashCutAfter (uint32_t words)
+{
+    cut_armed = true;
+    cut_words = words;
+}
+
+void
+hostFlashPowerOn (void)
+{
+    powered = true;
+    cut_armed = false;
+}
+
+void
+hostFlashGetStats (hostFlashStats_t *out)
+{
+    *out = stats;
+}
+
+// One unit of work (a word programmed or a sector erased), unless the
+// power has been cut.
+static bool
+spend (void)
+{
+    if (!powered)
+        return false;
+    if (cut_armed && cut_words-- == 0)
+    {
+        powered = false;
+        return false;
+    }
+    return true;
+}
+
+/*********************************************************
+ * driverlib flash API
+ *********************************************************/
+const uint32_t *
+hostFlashAt (uint32_t ui32Address)
+{
+    if (!loaded)
+        eraseAll ();
+    if (ui32Address >= FLASH_SIZE || (ui32Address & 3) != 0)
+    {
+        fprintf (stderr, "host: flash read at 0x%08x\n", ui32Address);
+        exit (2);
+    }
+    return &flash[ui32Address / 4];
+}
+
+int32_t
+FlashErase (uint32_t ui32Address)
+{
+    if (!loaded)
+        eraseAll ();
+    if (ui32Address >= FLASH_SIZE || (ui32Address & (SECTOR_SIZE - 1)) != 0)
+        return -1;
+    if (!spend ())
+        return -1;
+    memset (&flash[ui32Address / 4], 0xFF, SECTOR_SIZE);
+    stats.erases++;
+    return 0;
+}
+
+int32_t
+FlashProgram (uint32_t *pui32Data, uint32_t ui32Address, uint32_t ui32Count)
+{
+    uint32_t i;
+
+    if (!loaded)
+        eraseAll ();
+    if ((ui32Address & 3) != 0 || (ui32Count & 3) != 0
+        || ui32Address + ui32Count > FLASH_SIZE)
+        return -1;
+    for (i = 0; i < ui32Count / 4; i++)
+    {
+        if (!spend ())
+            return -1;
+        flash[ui32Address / 4 + i] &= pui32Data[i];
+        stats.words++;
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef HOSTFLASH_H_
+#define HOSTFLASH_H_
+
+/**********************************************************
+ *
+ * hostFlash.h
+ *
+ * Internal flash model, see hostFlash.c. Kept apart from
+ * hostHal.h so that host tools can link it on its own.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    9th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t erases;        // Sectors erased
+    uint32_t words;         // Words programmed
+} hostFlashStats_t;
+
+void hostFlashLoad (void);
+void hostFlashSave (void);
+void hostFlashReport (void);
+
+// Blank flash, power on, statistics cleared.
+void hostFlashReset (void);
+// Lets the given number of words (or erases) through, then cuts the
+// power: everything after is ignored until hostFlashPowerOn().
+void hostFlashCutAfter (uint32_t words);
+void hostFlashPowerOn (void);
+void hostFlashGetStats (hostFlashStats_t *stats);
+
+#endif /* HOSTFLASH_H_ */
@@ -0,0 +1,425 @@
+/**********************************************************
+ *
+ * hostGpio.c
+ *
+ * Host model of the GPIO ports used by the firmware. Pin
+ * levels come from the Orbit/Tiva push buttons (scripted
+ * through HOST_BUTTONS), from other peripheral models via
+ * hostGpioDrive(), or from the pad pull configuration.
+ * Edge and level interrupts are detected on pins driven
+ * through hostGpioDrive() and on the buttons. Each scripted
+ * press and release bounces, as a real contact does, for
+ * BOUNCE_TOGGLES extra changes BOUNCE_S apart.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    8th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "driverlib/gpio.h"
+#include "hostHal.h"
+
+#define NUM_PORTS       6
+#define MAX_PRESSES     32
+#define BOUNCE_TOGGLES  2           // Extra level changes after each edge
+#define BOUNCE_S        0.0005
+#define EDGES_PER_PRESS (2 * (1 + BOUNCE_TOGGLES))
+
+typedef struct {
+    uint32_t base;
+    uint32_t vector;
+    uint8_t pull_up;
+    uint8_t output;
+    uint8_t out_value;
+    uint8_t driven;
+    uint8_t drive_value;
+    uint8_t int_enabled;        // GPIOIM
+    uint8_t int_both;           // GPIOIBE
+    uint8_t int_level;          // GPIOIS, level rather than edge sensitive
+    uint8_t int_high;           // GPIOIEV, rising edge or high level
+    uint8_t int_raw;            // GPIORIS
+} port_t;
+
+typedef struct {
+    const char *name;
+    uint32_t port;
+    uint8_t pin;
+    bool active_high;
+} button_t;
+
+typedef struct {
+    uint8_t button;
+    double start;
+    double end;
+} press_t;
+
+typedef struct {
+    uint8_t button;
+    double time;
+} edge_t;
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static port_t ports[NUM_PORTS] = {
+    {GPIO_PORTA_BASE, INT_GPIOA}, {GPIO_PORTB_BASE, INT_GPIOB},
+    {GPIO_PORTC_BASE, INT_GPIOC}, {GPIO_PORTD_BASE, INT_GPIOD},
+    {GPIO_PORTE_BASE, INT_GPIOE}, {GPIO_PORTF_BASE, INT_GPIOF}
+};
+
+// Same pins and polarity as buttons4.h
+static const button_t buttons[] = {
+    {"UP",    GPIO_PORTE_BASE, GPIO_PIN_0, true},
+    {"DOWN",  GPIO_PORTD_BASE, GPIO_PIN_2, true},
+    {"LEFT",  GPIO_PORTF_BASE, GPIO_PIN_4, false},
+    {"RIGHT", GPIO_PORTF_BASE, GPIO_PIN_0, false},
+};
+#define NUM_BUTTONS (sizeof (buttons) / sizeof (buttons[0]))
+
+static press_t presses[MAX_PRESSES];
+static uint8_t num_presses;
+
+// Every change of a button level, in time order, so the pin interrupts
+// fire as they would on target.
+static edge_t edges[MAX_PRESSES * EDGES_PER_PRESS];
+static uint16_t num_edges;
+static uint16_t next_edge;
+
+static void buttonEdge (void);
+static hostEvent_t edge_event = {0, false, buttonEdge};
+
+static port_t *
+findPort (uint32_t base)
+{
+    uint8_t i;
+
+    for (i = 0; i < NUM_PORTS; i++)
+        if (ports[i].base == base)
+            return &ports[i];
+    fprintf (stderr, "host: unknown GPIO port 0x%08x\n", base);
+    exit (2);
+}
+
+static int
+compareEdges (const void *a, const void *b)
+{
+    double diff = ((const edge_t *) a)->time - ((const edge_t *) b)->time;
+
+    return (diff > 0) - (diff < 0);
+}
+
+static void
+sortEdges (void)
+{
+    uint8_t i, k;
+
+    num_edges = 0;
+    for (i = 0; i < num_presses; i++)
+    {
+        for (k = 0; k <= BOUNCE_TOGGLES; k++)
+        {
+            edges[num_edges].button = presses[i].button;
+            edges[num_edges++].time = presses[i].start + k * BOUNCE_S;
+            edges[num_edges].button = presses[i].button;
+            edges[num_edges++].time = presses[i].end + k * BOUNCE_S;
+        }
+    }
+    qsort (edges, num_edges, sizeof (edges[0]), compareEdges);
+}
+
+/*********************************************************
+ * hostGpioInit: parses HOST_BUTTONS, a comma separated list
+ * of name@start+held entries in virtual seconds.
+ *********************************************************/
+void
+hostGpioInit (void)
+{
+    const char *script = getenv ("HOST_BUTTONS");
+    char entry[32];
+    double start, held;
+    uint8_t b;
+    int len;
+
+    while (script != NULL && *script != '\0' && num_presses < MAX_PRESSES)
+    {
+        len = strcspn (script, ",");
+        snprintf (entry, sizeof (entry), "%.*s", len, script);
+        script += len + (script[len] == ',');
+
+        held = 0.1;
+        for (b = 0; b < NUM_BUTTONS; b++)
+        {
+            len = strlen (buttons[b].name);
+            if (strncmp (entry, buttons[b].name, len) == 0 && entry[len] == '@'
+                && sscanf (entry + len + 1, "%lf+%lf", &start, &held) >= 1)
+            {
+                presses[num_presses].button = b;
+                presses[num_presses].start = start;
+                presses[num_presses].end = start + held;
+                num_presses++;
+                break;
+            }
+        }
+        if (b == NUM_BUTTONS)
+            fprintf (stderr, "host: ignoring button entry '%s'\n", entry);
+    }
+    sortEdges ();
+}
+
+// Contact state of one edge (press or release) at time t: settled once
+// the bounce is over, otherwise alternating every BOUNCE_S.
+static bool
+bouncing (double edge, double t, bool *closed)
+{
+    uint8_t toggles;
+
+    if (t < edge || t >= edge + BOUNCE_TOGGLES * BOUNCE_S + BOUNCE_S)
+        return false;
+    toggles = (uint8_t) ((t - edge) / BOUNCE_S);
+    if (toggles > BOUNCE_TOGGLES)
+        toggles = BOUNCE_TOGGLES;
+    *closed = (toggles % 2) == 0;
+    return true;
+}
+
+static bool
+buttonHeld (uint8_t b, double t)
+{
+    bool closed;
+    uint8_t i;
+
+    for (i = 0; i < num_presses; i++)
+    {
+        if (presses[i].button != b)
+            continue;
+        if (bouncing (presses[i].end, t, &closed))
+            return !closed;
+        if (bouncing (presses[i].start, t, &closed) && !closed)
+            return false;
+        if (t >= presses[i].start && t < presses[i].end)
+            return true;
+    }
+    return false;
+}
+
+/*********************************************************
+ * hostGpioPinLevel: electrical level of one pin right now.
+ *********************************************************/
+bool
+hostGpioPinLevel (uint32_t port, uint8_t pin)
+{
+    port_t *p = findPort (port);
+    double t = hostSeconds ();
+    uint8_t b;
+
+    for (b = 0; b < NUM_BUTTONS; b++)
+        if (buttons[b].port == port && buttons[b].pin == pin)
+            return buttonHeld (b, t) == buttons[b].active_high;
+
+    if (p->driven & pin)
+        return (p->drive_value & pin) != 0;
+    if (p->output & pin)
+        return (p->out_value & pin) != 0;
+    return (p->pull_up & pin) != 0;
+}
+
+/*********************************************************
+ * updateInts: latches interrupt status for the pins whose
+ * level went from old to new, and raises the port vector.
+ *********************************************************/
+static void
+updateInts (port_t *p, uint8_t old, uint8_t new)
+{
+    uint8_t rose = ~old & new;
+    uint8_t fell = old & ~new;
+    uint8_t hit;
+
+    hit = (p->int_both & (rose | fell))
+        | (~p->int_both & ~p->int_level & p->int_high & rose)
+        | (~p->int_both & ~p->int_level & ~p->int_high & fell)
+        | (p->int_level & p->int_high & new)
+        | (p->int_level & ~p->int_high & ~new);
+    p->int_raw |= hit;
+    if (p->int_raw & p->int_enabled)
+        hostRaise (p->vector);
+}
+
+static uint8_t
+portLevels (port_t *p)
+{
+    uint8_t levels = 0;
+    uint8_t pin;
+
+    for (pin = 1; pin != 0; pin <<= 1)
+        if (hostGpioPinLevel (p->base, pin))
+            levels |= pin;
+    return levels;
+}
+
+void
+hostGpioDrive (uint32_t port, uint8_t pins, uint8_t levels)
+{
+    port_t *p = findPort (port);
+    uint8_t old = portLevels (p);
+
+    p->driven |= pins;
+    p->drive_value = (p->drive_value & ~pins) | (levels & pins);
+    updateInts (p, old, portLevels (p));
+}
+
+/*********************************************************
+ * Button edges: the virtual clock is only known once the
+ * firmware has set it, so the first edge is armed when a
+ * pin interrupt is first enabled.
+ *********************************************************/
+static void
+armNextEdge (void)
+{
+    uint64_t due;
+
+    if (edge_event.armed || next_edge >= num_edges)
+        return;
+    due = (uint64_t) (edges[next_edge].time * hostClockHz ()) + 1;
+    hostEventArm (&edge_event, due > hostNow () ? due : hostNow ());
+}
+
+static void
+buttonEdge (void)
+{
+    const button_t *button = &buttons[edges[next_edge++].button];
+    port_t *p = findPort (button->port);
+    uint8_t levels = portLevels (p);
+
+    updateInts (p, levels ^ button->pin, levels);
+    armNextEdge ();
+}
+
+/*********************************************************
+ * driverlib GPIO API
+ *********************************************************/
+void
+GPIOPinTypeGPIOInput (uint32_t ui32Port, uint8_t ui8Pins)
+{
+    findPort (ui32Port)->output &= ~ui8Pins;
+}
+
+void
+GPIOPinTypeGPIOOutput (uint32_t ui32Port, uint8_t ui8Pins)
+{
+    findPort (ui32Port)->output |= ui8Pins;
+}
+
+void
+GPIOPinTypeI2C (uint32_t ui32Port, uint8_t ui8Pins)
+{
+    findPort (ui32Port)->output &= ~ui8Pins;
+}
+
+void
+GPIOPinTypeI2CSCL (uint32_t ui32Port, uint8_t ui8Pins)
+{
+    findPort (ui32Port)->output &= ~ui8Pins;
+}
+
+void
+GPIOPinTypeUART (uint32_t ui32Port, uint8_t ui8Pins)
+{
+    findPort (ui32Port)->output &= ~ui8Pins;
+}
+
+void
+GPIOPinConfigure (uint32_t ui32PinConfig)
+{
+    (void) ui32PinConfig;
+}
+
+void
+GPIOPadConfigSet (uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32Strength,
+                  uint32_t ui32PadType)
+{
+    port_t *p = findPort (ui32Port);
+
+    (void) ui32Strength;
+    if (ui32PadType == GPIO_PIN_TYPE_STD_WPU)
+        p->pull_up |= ui8Pins;
+    else
+        p->pull_up &= ~ui8Pins;
+}
+
+int32_t
+GPIOPinRead (uint32_t ui32Port, uint8_t ui8Pins)
+{
+    int32_t value = 0;
+    uint8_t pin;
+
+    for (pin = 1; pin != 0; pin <<= 1)
+        if ((ui8Pins & pin) && hostGpioPinLevel (ui32Port, pin))
+            value |= pin;
+    return value;
+}
+
+void
+GPIOPinWrite (uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    port_t *p = findPort (ui32Port);
+
+    p->out_value = (p->out_value & ~ui8Pins) | (ui8Val & ui8Pins);
+}
+
+void
+GPIOIntTypeSet (uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32IntType)
+{
+    port_t *p = findPort (ui32Port);
+
+    p->int_both = (ui32IntType & GPIO_BOTH_EDGES) ? p->int_both | ui8Pins
+                                                  : p->int_both & ~ui8Pins;
+    p->int_level = (ui32IntType & GPIO_LOW_LEVEL) ? p->int_level | ui8Pins
+                                                  : p->int_level & ~ui8Pins;
+    p->int_high = (ui32IntType & GPIO_RISING_EDGE) ? p->int_high | ui8Pins
+                                                   : p->int_high & ~ui8Pins;
+}
+
+void
+GPIOIntEnable (uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+    port_t *p = findPort (ui32Port);
+    uint8_t levels = portLevels (p);
+
+    p->int_enabled |= ui32IntFlags;
+    armNextEdge ();
+    // A level sensitive pin that is already active interrupts at once.
+    updateInts (p, levels, levels);
+    hostDispatch ();
+}
+
+void
+GPIOIntDisable (uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+    findPort (ui32Port)->int_enabled &= ~ui32IntFlags;
+}
+
+uint32_t
+GPIOIntStatus (uint32_t ui32Port, bool bMasked)
+{
+    port_t *p = findPort (ui32Port);
+
+    return bMasked ? p->int_raw & p->int_enabled : p->int_raw;
+}
+
+void
+GPIOIntClear (uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+    port_t *p = findPort (ui32Port);
+    uint8_t levels = portLevels (p);
+
+    p->int_raw &= ~ui32IntFlags;
+    // Level interrupts re-assert while the pin stays active.
+    updateInts (p, levels, levels);
+}
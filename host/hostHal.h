@@ -0,0 +1,154 @@
+#ifndef HOSTHAL_H_
+#define HOSTHAL_H_
+
+/**********************************************************
+ *
+ * hostHal.h
+ *
+ * Native Linux backend for the TivaWare driverlib and
+ * OrbitOLED calls made by the pedometer firmware. The
+ * firmware sources in ../Project are compiled unchanged
+ * against the stand-in headers in include/ and run against
+ * a virtual clock, so main()'s loop can be driven from a
+ * recorded accelerometer trace faster than real time.
+ *
+ * Environment variables read at start-up:
+ *   HOST_TRACE    path of an x,y,z[,step] trace (see traces/)
+ *   HOST_BUTTONS  button presses, e.g. "DOWN@5.0+0.8,UP@9+2"
+ *                 (name@start_seconds+held_seconds)
+ *   HOST_QUIET    set to suppress the end of run report
+ *   HOST_CPU_SCALE  target cycles per host nanosecond of
+ *                 firmware run time, for the power report
+ *   HOST_FLASH    file holding the internal flash between runs
+ *   HOST_UART     file the UART0 (telemetry) output is written to
+ *   HOST_EEPROM   file holding the EEPROM between runs
+ *   HOST_ACCL_BIAS  zero-g offset of the modelled ADXL345 in
+ *                 counts, e.g. "12,-8,20"
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    8th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************
+ * Virtual clock (in CPU cycles at the SysCtlClockSet rate)
+ **********************************************************/
+uint64_t hostNow (void);
+void hostSetNow (uint64_t cycles);
+void hostAdvance (uint64_t cycles);
+uint32_t hostClockHz (void);
+double hostSeconds (void);
+
+// Marks the start of one firmware loop iteration (a SysCtlDelay or
+// a sleep). Per-iteration wall-clock cost is measured between
+// consecutive marks. Ends the run (report then exit(0)) once the
+// trace has been consumed.
+void hostLoopMark (void);
+
+// Prints the end of run report and exits.
+void hostFinish (void);
+
+// Wall clock in nanoseconds, for host-side timing.
+uint64_t hostWallNs (void);
+
+/**********************************************************
+ * Timed events and interrupts
+ *
+ * Peripheral models arm events on the virtual clock; they
+ * fire as hostAdvance() or a sleep moves time past them.
+ * Raised interrupts are taken (in vector number order)
+ * whenever the firmware is not already in a handler and
+ * interrupts are not masked.
+ **********************************************************/
+typedef struct {
+    uint64_t due;
+    bool armed;
+    void (*fire) (void);
+} hostEvent_t;
+
+void hostEventArm (hostEvent_t *event, uint64_t due);
+void hostEventCancel (hostEvent_t *event);
+
+void hostRaise (uint32_t vector);
+void hostDispatch (void);
+bool hostInIsr (void);
+// Waits for an enabled interrupt (WFI), then takes it if unmasked.
+// deep selects deep sleep for the power accounting.
+void hostSleep (bool deep);
+
+// Vector table, indexed as in tm4c123gh6pm_startup_ccs.c
+typedef void (*hostVector_t) (void);
+hostVector_t hostVector (uint32_t vector);
+void hostSysTickReport (void);
+
+/**********************************************************
+ * Power and duty cycle
+ *
+ * The virtual clock stands still while firmware runs, so
+ * the time awake is estimated from the host wall clock
+ * between wake-ups, scaled by HOST_CPU_SCALE.
+ **********************************************************/
+void hostPowerSleep (void);
+void hostPowerWake (bool deep, uint64_t slept_cycles);
+void hostPowerReport (void);
+
+/**********************************************************
+ * Memory mapped registers used through HWREG()
+ **********************************************************/
+volatile uint32_t *hostReg (uint32_t addr);
+
+/**********************************************************
+ * Trace playback
+ **********************************************************/
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    uint8_t step;       // 1 on the sample at which a labelled step lands
+} hostSample_t;
+
+// Loads the trace named by HOST_TRACE (or a flat 10 s stationary
+// trace if it is unset). Safe to call more than once.
+void hostTraceLoad (void);
+bool hostTraceOpen (const char *path);
+uint32_t hostTraceLength (void);
+uint32_t hostTraceRateHz (void);
+const char *hostTraceName (void);
+const hostSample_t *hostTraceAt (uint32_t index);
+// Sample index corresponding to the current virtual time.
+uint32_t hostTraceIndexNow (void);
+bool hostTraceFinished (void);
+
+/**********************************************************
+ * Peripheral models
+ **********************************************************/
+void hostGpioInit (void);
+bool hostGpioPinLevel (uint32_t port, uint8_t pin);
+void hostGpioDrive (uint32_t port, uint8_t pins, uint8_t levels);
+
+typedef struct {
+    uint8_t addr;                       // 7-bit address
+    bool (*start) (bool read);          // false = NACK
+    void (*write) (uint8_t byte);
+    uint8_t (*read) (void);
+    void (*stop) (void);
+} hostI2cDevice_t;
+
+void hostI2cAttach (const hostI2cDevice_t *device);
+void hostAdxl345Attach (void);
+void hostAdxl345Report (void);
+
+double hostAdxl345AverageUa (void);
+
+void hostTimerReport (void);
+void hostUartReport (void);
+void hostEepromLoad (void);
+void hostEepromSave (void);
+void hostEepromReport (void);
+void hostOledReport (void);
+void hostI2cReport (void);
+
+#endif /* HOSTHAL_H_ */
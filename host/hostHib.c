@@ -0,0 +1,63 @@
+/**********************************************************
+ *
+ * hostHib.c
+ *
+ * Model of the hibernation module's RTC. It counts whole
+ * seconds of the virtual clock from HibernateRTCEnable(),
+ * through sleep and deep sleep alike. The rest of the
+ * module (hibernation itself, its memory and the match
+ * interrupt) is not modelled.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    9th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "driverlib/hibernate.h"
+#include "hostHal.h"
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static bool clock_on;
+static bool rtc_on;
+static uint64_t rtc_start;
+
+void
+HibernateEnableExpClk (uint32_t ui32HibClk)
+{
+    (void) ui32HibClk;
+    clock_on = true;
+}
+
+void
+HibernateClockConfig (uint32_t ui32Config)
+{
+    if (ui32Config & HIBERNATE_OSC_DISABLE)
+        clock_on = false;
+}
+
+void
+HibernateRTCEnable (void)
+{
+    if (!clock_on)
+    {
+        fprintf (stderr, "host: RTC enabled before its clock\n");
+        exit (2);
+    }
+    if (!rtc_on)
+        rtc_start = hostNow ();
+    rtc_on = true;
+}
+
+uint32_t
+HibernateRTCGet (void)
+{
+    if (!rtc_on)
+        return 0;
+    return (uint32_t) ((hostNow () - rtc_start) / hostClockHz ());
+}
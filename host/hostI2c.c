@@ -0,0 +1,229 @@
+/**********************************************************
+ *
+ * hostI2c.c
+ *
+ * Host model of the I2C0 master. Each command issued through
+ * I2CMasterControl is carried out against the attached
+ * device model straight away, but the master then reports
+ * busy until the bytes would have left the wire, when the
+ * master interrupt is raised. Polling I2CMasterBusy spins
+ * the virtual clock forward to that point.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    8th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "driverlib/i2c.h"
+#include "hostHal.h"
+
+#define MAX_DEVICES     4
+#define BITS_PER_BYTE   9       // 8 data bits plus ACK
+
+#define CMD_RUN         0x01
+#define CMD_START       0x02
+#define CMD_STOP        0x04
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static const hostI2cDevice_t *devices[MAX_DEVICES];
+static uint8_t num_devices;
+
+static const hostI2cDevice_t *active;   // device addressed by the last START
+static uint8_t slave_addr;
+static bool receive;
+static bool bus_busy;                   // between START and STOP
+static uint8_t data_reg;
+static uint32_t error;
+static uint32_t bus_hz = 100000;
+static bool busy;                       // command still on the wire
+static bool raw_int;
+static bool int_enabled;
+static uint64_t pending_bits;
+
+static void commandDone (void);
+static hostEvent_t done_event = {0, false, commandDone};
+
+static uint32_t stat_transactions;
+static uint32_t stat_bytes;
+static uint64_t stat_bus_cycles;
+
+void
+hostI2cAttach (const hostI2cDevice_t *device)
+{
+    if (num_devices < MAX_DEVICES)
+        devices[num_devices++] = device;
+}
+
+static const hostI2cDevice_t *
+findDevice (uint8_t addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < num_devices; i++)
+        if (devices[i]->addr == addr)
+            return devices[i];
+    return NULL;
+}
+
+static void
+busTime (uint32_t bits)
+{
+    pending_bits += bits;
+}
+
+static void
+commandDone (void)
+{
+    busy = false;
+    raw_int = true;
+    if (int_enabled)
+        hostRaise (INT_I2C0);
+}
+
+void
+hostI2cReport (void)
+{
+    printf ("host: i2c %u transactions, %u bytes, %.1f ms on the bus\n",
+            stat_transactions, stat_bytes,
+            stat_bus_cycles * 1000.0 / hostClockHz ());
+}
+
+/*********************************************************
+ * driverlib I2C master API
+ *********************************************************/
+void
+I2CMasterInitExpClk (uint32_t ui32Base, uint32_t ui32I2CClk, bool bFast)
+{
+    (void) ui32Base;
+    (void) ui32I2CClk;
+    bus_hz = bFast ? 400000 : 100000;
+}
+
+void
+I2CMasterSlaveAddrSet (uint32_t ui32Base, uint8_t ui8SlaveAddr, bool bReceive)
+{
+    (void) ui32Base;
+    slave_addr = ui8SlaveAddr;
+    receive = bReceive;
+}
+
+void
+I2CMasterDataPut (uint32_t ui32Base, uint8_t ui8Data)
+{
+    (void) ui32Base;
+    data_reg = ui8Data;
+}
+
+uint32_t
+I2CMasterDataGet (uint32_t ui32Base)
+{
+    (void) ui32Base;
+    return data_reg;
+}
+
+void
+I2CMasterControl (uint32_t ui32Base, uint32_t ui32Cmd)
+{
+    uint64_t cycles;
+
+    (void) ui32Base;
+    pending_bits = 0;
+
+    if (ui32Cmd & CMD_START)
+    {
+        // (Repeated) start plus the address byte.
+        busTime (1 + BITS_PER_BYTE);
+        stat_transactions++;
+        bus_busy = true;
+        error = I2C_MASTER_ERR_NONE;
+        active = findDevice (slave_addr);
+        if (active == NULL || !active->start (receive))
+        {
+            active = NULL;
+            error = I2C_MASTER_ERR_ADDR_ACK;
+        }
+    }
+
+    if ((ui32Cmd & CMD_RUN) && active != NULL)
+    {
+        busTime (BITS_PER_BYTE);
+        stat_bytes++;
+        if (receive)
+            data_reg = active->read ();
+        else
+            active->write (data_reg);
+    }
+
+    if (ui32Cmd & CMD_STOP)
+    {
+        busTime (1);
+        if (active != NULL)
+            active->stop ();
+        active = NULL;
+        bus_busy = false;
+    }
+
+    cycles = pending_bits * hostClockHz () / bus_hz;
+    stat_bus_cycles += cycles;
+    busy = true;
+    raw_int = false;
+    hostEventArm (&done_event, hostNow () + cycles);
+}
+
+bool
+I2CMasterBusy (uint32_t ui32Base)
+{
+    (void) ui32Base;
+    if (busy && done_event.armed)
+        hostAdvance (done_event.due - hostNow ());
+    return busy;
+}
+
+bool
+I2CMasterBusBusy (uint32_t ui32Base)
+{
+    (void) ui32Base;
+    return bus_busy;
+}
+
+uint32_t
+I2CMasterErr (uint32_t ui32Base)
+{
+    (void) ui32Base;
+    return error;
+}
+
+void
+I2CMasterIntEnable (uint32_t ui32Base)
+{
+    (void) ui32Base;
+    int_enabled = true;
+}
+
+void
+I2CMasterIntDisable (uint32_t ui32Base)
+{
+    (void) ui32Base;
+    int_enabled = false;
+}
+
+void
+I2CMasterIntClear (uint32_t ui32Base)
+{
+    (void) ui32Base;
+    raw_int = false;
+}
+
+bool
+I2CMasterIntStatus (uint32_t ui32Base, bool bMasked)
+{
+    (void) ui32Base;
+    return bMasked ? raw_int && int_enabled : raw_int;
+}
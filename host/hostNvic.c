@@ -0,0 +1,240 @@
+/**********************************************************
+ *
+ * hostNvic.c
+ *
+ * Timed events on the virtual clock and a model of the NVIC
+ * for the host build. There is no preemption between
+ * handlers: a raised interrupt is taken as soon as the
+ * firmware is in thread mode with interrupts unmasked, which
+ * is at the next driverlib call that moves the clock or
+ * unmasks interrupts.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "inc/hw_ints.h"
+#include "driverlib/interrupt.h"
+#include "hostHal.h"
+
+#define MAX_EVENTS  16
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static hostEvent_t *events[MAX_EVENTS];
+static uint8_t num_events;
+
+static bool pending[NUM_INTERRUPTS];
+static bool enabled[NUM_INTERRUPTS];   // system exceptions are always on
+static bool masked = true;          // PRIMASK is set out of reset by CCS
+static bool in_isr;
+
+/*********************************************************
+ * Timed events
+ *********************************************************/
+void
+hostEventArm (hostEvent_t *event, uint64_t due)
+{
+    uint8_t i;
+
+    for (i = 0; i < num_events; i++)
+        if (events[i] == event)
+            break;
+    if (i == num_events)
+    {
+        if (num_events == MAX_EVENTS)
+        {
+            fprintf (stderr, "host: too many timed events\n");
+            return;
+        }
+        events[num_events++] = event;
+    }
+    event->due = due;
+    event->armed = true;
+}
+
+void
+hostEventCancel (hostEvent_t *event)
+{
+    event->armed = false;
+}
+
+static hostEvent_t *
+nextEvent (void)
+{
+    hostEvent_t *next = NULL;
+    uint8_t i;
+
+    for (i = 0; i < num_events; i++)
+        if (events[i]->armed && (next == NULL || events[i]->due < next->due))
+            next = events[i];
+    return next;
+}
+
+static void
+fireEvent (hostEvent_t *event)
+{
+    hostSetNow (event->due);
+    event->armed = false;
+    event->fire ();
+}
+
+/*********************************************************
+ * hostAdvance: moves the virtual clock on, firing events
+ * and taking interrupts as it goes.
+ *********************************************************/
+void
+hostAdvance (uint64_t cycles)
+{
+    uint64_t target = hostNow () + cycles;
+    hostEvent_t *event;
+
+    while ((event = nextEvent ()) != NULL && event->due <= target)
+    {
+        fireEvent (event);
+        hostDispatch ();
+    }
+    hostSetNow (target);
+}
+
+/*********************************************************
+ * Interrupts
+ *********************************************************/
+void
+hostRaise (uint32_t vector)
+{
+    if (vector < NUM_INTERRUPTS)
+        pending[vector] = true;
+}
+
+static int32_t
+nextPending (void)
+{
+    uint32_t vector;
+
+    for (vector = 0; vector < NUM_INTERRUPTS; vector++)
+        if (pending[vector] && (enabled[vector] || vector < INT_GPIOA))
+            return vector;
+    return -1;
+}
+
+void
+hostDispatch (void)
+{
+    int32_t vector;
+    hostVector_t handler;
+
+    if (in_isr || masked)
+        return;
+
+    while ((vector = nextPending ()) >= 0)
+    {
+        pending[vector] = false;
+        handler = hostVector (vector);
+        if (handler == NULL)
+        {
+            fprintf (stderr, "host: interrupt %d has no handler\n", vector);
+            hostFinish ();
+        }
+        in_isr = true;
+        handler ();
+        in_isr = false;
+    }
+}
+
+bool
+hostInIsr (void)
+{
+    return in_isr;
+}
+
+void
+hostSleep (bool deep)
+{
+    uint64_t start = hostNow ();
+    hostEvent_t *event;
+
+    hostPowerSleep ();
+    while (nextPending () < 0)
+    {
+        event = nextEvent ();
+        if (event == NULL)
+        {
+            // Nothing can ever wake the CPU again.
+            fprintf (stderr, "host: sleeping with no wake-up source\n");
+            hostFinish ();
+        }
+        fireEvent (event);
+    }
+    hostPowerWake (deep, hostNow () - start);
+    hostDispatch ();
+}
+
+/*********************************************************
+ * driverlib NVIC API
+ *********************************************************/
+bool
+IntMasterEnable (void)
+{
+    bool was_masked = masked;
+
+    masked = false;
+    hostDispatch ();
+    return was_masked;
+}
+
+bool
+IntMasterDisable (void)
+{
+    bool was_masked = masked;
+
+    masked = true;
+    return was_masked;
+}
+
+void
+IntEnable (uint32_t ui32Interrupt)
+{
+    if (ui32Interrupt < NUM_INTERRUPTS)
+        enabled[ui32Interrupt] = true;
+    hostDispatch ();
+}
+
+void
+IntDisable (uint32_t ui32Interrupt)
+{
+    if (ui32Interrupt < NUM_INTERRUPTS)
+        enabled[ui32Interrupt] = false;
+}
+
+bool
+IntIsEnabled (uint32_t ui32Interrupt)
+{
+    return ui32Interrupt < NUM_INTERRUPTS && enabled[ui32Interrupt];
+}
+
+void
+IntPrioritySet (uint32_t ui32Interrupt, uint8_t ui8Priority)
+{
+    (void) ui32Interrupt;
+    (void) ui8Priority;
+}
+
+void
+IntPendSet (uint32_t ui32Interrupt)
+{
+    hostRaise (ui32Interrupt);
+    hostDispatch ();
+}
+
+void
+IntPendClear (uint32_t ui32Interrupt)
+{
+    if (ui32Interrupt < NUM_INTERRUPTS)
+        pending[ui32Interrupt] = false;
+}
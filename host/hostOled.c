@@ -0,0 +1,58 @@
+/**********************************************************
+ *
+ * hostOled.c
+ *
+ * Host model of the Orbit OLED: a 4 x 16 character frame
+ * buffer plus counts of the draw calls and characters sent,
+ * which stand in for the SPI traffic on target.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    8th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "OrbitOLED/OrbitOLEDInterface.h"
+#include "hostHal.h"
+
+#define OLED_ROWS   4
+#define OLED_COLS   16
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static char frame[OLED_ROWS][OLED_COLS];
+static uint32_t stat_draws;
+static uint32_t stat_chars;
+
+void
+OLEDInitialise (void)
+{
+    memset (frame, ' ', sizeof (frame));
+}
+
+void
+OLEDStringDraw (const char *pcStr, uint32_t ulColumn, uint32_t ulRow)
+{
+    stat_draws++;
+    if (ulRow >= OLED_ROWS)
+        return;
+    while (*pcStr != '\0' && ulColumn < OLED_COLS)
+    {
+        frame[ulRow][ulColumn++] = *pcStr++;
+        stat_chars++;
+    }
+}
+
+void
+hostOledReport (void)
+{
+    uint8_t row;
+
+    printf ("host: oled %u draw calls, %u characters\n", stat_draws,
+            stat_chars);
+    for (row = 0; row < OLED_ROWS; row++)
+        printf ("host: |%.*s|\n", OLED_COLS, frame[row]);
+}
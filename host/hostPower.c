@@ -0,0 +1,103 @@
+/**********************************************************
+ *
+ * hostPower.c
+ *
+ * Duty cycle and power estimate for a host run. Sleep and
+ * deep sleep time come from the virtual clock. The virtual
+ * clock stands still while the firmware runs, so the awake
+ * time is estimated instead: the host wall time between a
+ * wake-up and the next sleep, times HOST_CPU_SCALE target
+ * cycles per nanosecond. This is a rough figure. The host
+ * retires several instructions per nanosecond, but part of
+ * that time goes to the peripheral models.
+ *
+ * The currents are ballpark typical figures: TM4C123 at
+ * 20 MHz from the PLL, and ADXL345 at 2.5 V (see
+ * hostAdxl345.c). They give a rough estimate, not a
+ * measurement.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    29th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "hostHal.h"
+
+#define DEFAULT_CPU_SCALE   2.0     // Target cycles per host ns
+#define MCU_RUN_MA          15.0
+#define MCU_SLEEP_MA        7.0
+#define MCU_DEEP_SLEEP_MA   1.5
+#define SECONDS_PER_HOUR    3600.0
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static uint64_t awake_since_ns;         // Wall time of the last wake-up
+static uint64_t awake_ns;
+static uint64_t sleep_cycles;
+static uint64_t deep_cycles;
+static uint32_t wakes;
+static uint32_t deep_wakes;
+
+void
+hostPowerSleep (void)
+{
+    uint64_t now = hostWallNs ();
+
+    if (awake_since_ns != 0)
+        awake_ns += now - awake_since_ns;
+    awake_since_ns = 0;
+}
+
+void
+hostPowerWake (bool deep, uint64_t slept_cycles)
+{
+    if (deep)
+    {
+        deep_cycles += slept_cycles;
+        deep_wakes++;
+    }
+    else
+    {
+        sleep_cycles += slept_cycles;
+    }
+    wakes++;
+    awake_since_ns = hostWallNs ();
+}
+
+/*********************************************************
+ * hostPowerReport: fractions are of the virtual run time
+ * plus the estimated awake time.
+ *********************************************************/
+void
+hostPowerReport (void)
+{
+    const char *scale_env = getenv ("HOST_CPU_SCALE");
+    double scale = scale_env ? atof (scale_env) : DEFAULT_CPU_SCALE;
+    double awake = awake_ns * scale;
+    double total = hostNow () + awake;
+    double run_f, sleep_f, deep_f;
+    double adxl_ua = hostAdxl345AverageUa ();
+
+    if (total <= 0)
+        return;
+    run_f = awake / total;
+    sleep_f = sleep_cycles / total;
+    deep_f = deep_cycles / total;
+
+    printf ("host: power cpu awake %.2f%%, sleep %.2f%%, deep sleep %.2f%%;"
+            " %u wake-ups (%u from deep sleep)\n", 100.0 * run_f,
+            100.0 * sleep_f, 100.0 * deep_f, wakes, deep_wakes);
+    printf ("host: power per hour of this trace: cpu awake %.1f s,"
+            " %.0f wake-ups\n", run_f * SECONDS_PER_HOUR,
+            hostSeconds () > 0 ? wakes * SECONDS_PER_HOUR / hostSeconds ()
+                               : 0.0);
+    printf ("host: power estimate mcu %.2f mA, adxl345 %.1f uA"
+            " (HOST_CPU_SCALE %.1f, typical currents)\n",
+            run_f * MCU_RUN_MA + sleep_f * MCU_SLEEP_MA
+            + deep_f * MCU_DEEP_SLEEP_MA, adxl_ua, scale);
+}
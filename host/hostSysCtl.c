@@ -0,0 +1,115 @@
+/**********************************************************
+ *
+ * hostSysCtl.c
+ *
+ * Host model of the TivaWare system control calls. The
+ * clock configuration sets the rate of the virtual clock and
+ * SysCtlDelay advances it instead of spinning.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    8th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib/sysctl.h"
+#include "hostHal.h"
+
+#define PLL_HZ      200000000   // 400 MHz PLL, fixed divide by 2
+#define XTAL_HZ     16000000
+
+static uint32_t clock_hz = XTAL_HZ;     // PIOSC/MOSC rate out of reset
+
+uint32_t
+hostClockHz (void)
+{
+    return clock_hz;
+}
+
+void
+SysCtlClockSet (uint32_t ui32Config)
+{
+    uint32_t div = (ui32Config & SYSCTL_SYSDIV_M) >> 23;
+
+    if (div == 0)
+        div = 1;
+    if ((ui32Config & SYSCTL_USE_OSC) == SYSCTL_USE_OSC)
+        clock_hz = XTAL_HZ / div;
+    else
+        clock_hz = PLL_HZ / div;
+}
+
+uint32_t
+SysCtlClockGet (void)
+{
+    return clock_hz;
+}
+
+// SysCtlDelay is a 3 cycle loop on target. The firmware uses it to pace
+// its main loop, so each call also marks one loop iteration.
+void
+SysCtlDelay (uint32_t ui32Count)
+{
+    hostLoopMark ();
+    hostAdvance ((uint64_t) ui32Count * 3);
+}
+
+void
+SysCtlPeripheralEnable (uint32_t ui32Peripheral)
+{
+    (void) ui32Peripheral;
+}
+
+void
+SysCtlPeripheralReset (uint32_t ui32Peripheral)
+{
+    (void) ui32Peripheral;
+}
+
+bool
+SysCtlPeripheralReady (uint32_t ui32Peripheral)
+{
+    (void) ui32Peripheral;
+    return true;
+}
+
+// WFI: the host sleeps by moving the virtual clock on to the next event.
+void
+SysCtlSleep (void)
+{
+    hostLoopMark ();
+    hostSleep (false);
+}
+
+// Deep sleep wakes the same way; it differs only in the power accounting.
+void
+SysCtlDeepSleep (void)
+{
+    hostLoopMark ();
+    hostSleep (true);
+}
+
+void
+SysCtlDeepSleepClockSet (uint32_t ui32Config)
+{
+    (void) ui32Config;
+}
+
+void
+SysCtlPeripheralSleepEnable (uint32_t ui32Peripheral)
+{
+    (void) ui32Peripheral;
+}
+
+void
+SysCtlPeripheralDeepSleepEnable (uint32_t ui32Peripheral)
+{
+    (void) ui32Peripheral;
+}
+
+void
+SysCtlPeripheralClockGating (bool bEnable)
+{
+    (void) bEnable;
+}
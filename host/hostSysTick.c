@@ -0,0 +1,99 @@
+/**********************************************************
+ *
+ * hostSysTick.c
+ *
+ * Host model of the SysTick timer: a down counter reloaded
+ * from the period register, raising FAULT_SYSTICK on each
+ * wrap when its interrupt is enabled.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "inc/hw_ints.h"
+#include "driverlib/systick.h"
+#include "hostHal.h"
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static uint32_t period = 1;
+static bool running;
+static bool int_enabled;
+static uint64_t started;
+static uint32_t stat_ticks;
+
+static void sysTickWrap (void);
+static hostEvent_t wrap_event = {0, false, sysTickWrap};
+
+static void
+sysTickWrap (void)
+{
+    stat_ticks++;
+    if (int_enabled)
+        hostRaise (FAULT_SYSTICK);
+    hostEventArm (&wrap_event, wrap_event.due + period);
+}
+
+void
+hostSysTickReport (void)
+{
+    if (stat_ticks > 0)
+        printf ("host: systick %u ticks, period %u cycles\n", stat_ticks,
+                period);
+}
+
+/*********************************************************
+ * driverlib SysTick API
+ *********************************************************/
+void
+SysTickEnable (void)
+{
+    running = true;
+    started = hostNow ();
+    hostEventArm (&wrap_event, started + period);
+}
+
+void
+SysTickDisable (void)
+{
+    running = false;
+    hostEventCancel (&wrap_event);
+}
+
+void
+SysTickIntEnable (void)
+{
+    int_enabled = true;
+    hostDispatch ();
+}
+
+void
+SysTickIntDisable (void)
+{
+    int_enabled = false;
+}
+
+void
+SysTickPeriodSet (uint32_t ui32Period)
+{
+    period = ui32Period;
+}
+
+uint32_t
+SysTickPeriodGet (void)
+{
+    return period;
+}
+
+uint32_t
+SysTickValueGet (void)
+{
+    if (!running)
+        return 0;
+    return period - 1 - (uint32_t) ((hostNow () - started) % period);
+}
@@ -0,0 +1,182 @@
+/**********************************************************
+ *
+ * hostTimer.c
+ *
+ * Host model of general purpose timers 0 and 1, side A, as
+ * 32-bit down counters clocked at the system clock. In
+ * one-shot mode a timer stops at zero; in periodic mode it
+ * reloads. Each time-out raises the timer's A interrupt
+ * when it is enabled. Only the down-counting
+ * configurations are modelled.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    6th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "driverlib/timer.h"
+#include "hostHal.h"
+
+#define NUM_TIMERS  2
+
+typedef struct {
+    uint32_t base;
+    uint32_t vector;
+    bool periodic;
+    uint32_t load;
+    bool running;
+    uint8_t int_enabled;
+    uint8_t int_raw;
+    uint32_t stat_timeouts;
+    hostEvent_t timeout_event;
+} hostTimer_t;
+
+static void timer0Timeout (void);
+static void timer1Timeout (void);
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static hostTimer_t timers[NUM_TIMERS] = {
+    {TIMER0_BASE, INT_TIMER0A, false, 0xFFFFFFFF, false, 0, 0, 0,
+     {0, false, timer0Timeout}},
+    {TIMER1_BASE, INT_TIMER1A, false, 0xFFFFFFFF, false, 0, 0, 0,
+     {0, false, timer1Timeout}}
+};
+
+static hostTimer_t *
+timerAt (uint32_t base)
+{
+    uint8_t i;
+
+    for (i = 0; i < NUM_TIMERS; i++)
+        if (timers[i].base == base)
+            return &timers[i];
+    fprintf (stderr, "host: timer 0x%08x is not modelled\n", base);
+    exit (2);
+}
+
+static void
+timerTimeout (hostTimer_t *timer)
+{
+    timer->stat_timeouts++;
+    timer->int_raw |= TIMER_TIMA_TIMEOUT;
+    if (timer->int_raw & timer->int_enabled)
+        hostRaise (timer->vector);
+    if (timer->periodic)
+        hostEventArm (&timer->timeout_event,
+                      timer->timeout_event.due + timer->load + 1);
+    else
+        timer->running = false;
+}
+
+static void
+timer0Timeout (void)
+{
+    timerTimeout (&timers[0]);
+}
+
+static void
+timer1Timeout (void)
+{
+    timerTimeout (&timers[1]);
+}
+
+void
+hostTimerReport (void)
+{
+    uint8_t i;
+
+    for (i = 0; i < NUM_TIMERS; i++)
+        if (timers[i].stat_timeouts > 0)
+            printf ("host: timer%u  %u time-outs\n", i,
+                    timers[i].stat_timeouts);
+}
+
+/*********************************************************
+ * driverlib timer API
+ *********************************************************/
+void
+TimerConfigure (uint32_t ui32Base, uint32_t ui32Config)
+{
+    hostTimer_t *timer = timerAt (ui32Base);
+
+    timer->running = false;
+    hostEventCancel (&timer->timeout_event);
+    timer->periodic = (ui32Config & 0x0F) == (TIMER_CFG_PERIODIC & 0x0F);
+}
+
+void
+TimerEnable (uint32_t ui32Base, uint32_t ui32Timer)
+{
+    hostTimer_t *timer = timerAt (ui32Base);
+
+    (void) ui32Timer;
+    timer->running = true;
+    hostEventArm (&timer->timeout_event, hostNow () + timer->load + 1);
+}
+
+void
+TimerDisable (uint32_t ui32Base, uint32_t ui32Timer)
+{
+    hostTimer_t *timer = timerAt (ui32Base);
+
+    (void) ui32Timer;
+    timer->running = false;
+    hostEventCancel (&timer->timeout_event);
+}
+
+void
+TimerLoadSet (uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    (void) ui32Timer;
+    timerAt (ui32Base)->load = ui32Value;
+}
+
+uint32_t
+TimerValueGet (uint32_t ui32Base, uint32_t ui32Timer)
+{
+    hostTimer_t *timer = timerAt (ui32Base);
+
+    (void) ui32Timer;
+    if (!timer->running)
+        return timer->load;
+    return (uint32_t) (timer->timeout_event.due - hostNow ()) - 1;
+}
+
+void
+TimerIntEnable (uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    hostTimer_t *timer = timerAt (ui32Base);
+
+    timer->int_enabled |= ui32IntFlags;
+    if (timer->int_raw & timer->int_enabled)
+        hostRaise (timer->vector);
+    hostDispatch ();
+}
+
+void
+TimerIntDisable (uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    timerAt (ui32Base)->int_enabled &= ~ui32IntFlags;
+}
+
+uint32_t
+TimerIntStatus (uint32_t ui32Base, bool bMasked)
+{
+    hostTimer_t *timer = timerAt (ui32Base);
+
+    return bMasked ? timer->int_raw & timer->int_enabled : timer->int_raw;
+}
+
+void
+TimerIntClear (uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    timerAt (ui32Base)->int_raw &= ~ui32IntFlags;
+}
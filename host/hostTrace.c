@@ -0,0 +1,163 @@
+/**********************************************************
+ *
+ * hostTrace.c
+ *
+ * Loads recorded accelerometer traces for playback through
+ * the ADXL345 model. A trace is a text file of raw 13-bit
+ * full resolution readings (256 counts per g), one sample
+ * per line:
+ *
+ *     # rate_hz=100
+ *     x,y,z[,step]
+ *
+ * Lines starting with '#' are comments; the optional fourth
+ * column is 1 on samples labelled as a step.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    8th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hostHal.h"
+
+#define DEFAULT_RATE_HZ     100
+#define FLAT_TRACE_SECONDS  10
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static hostSample_t *samples;
+static uint32_t num_samples;
+static uint32_t rate_hz = DEFAULT_RATE_HZ;
+static char name[256] = "(none)";
+static bool loaded;
+
+/*********************************************************
+ * hostTraceOpen: replaces the current trace with the file
+ * at path. Returns false if it cannot be read.
+ *********************************************************/
+bool
+hostTraceOpen (const char *path)
+{
+    FILE *fp;
+    char line[128];
+    uint32_t capacity = 1024;
+    int x, y, z, step;
+    int fields;
+    const char *base;
+
+    fp = fopen (path, "r");
+    if (fp == NULL)
+        return false;
+
+    free (samples);
+    samples = malloc (capacity * sizeof (hostSample_t));
+    num_samples = 0;
+    rate_hz = DEFAULT_RATE_HZ;
+
+    while (fgets (line, sizeof (line), fp) != NULL)
+    {
+        if (line[0] == '#')
+        {
+            sscanf (line, "# rate_hz=%u", &rate_hz);
+            continue;
+        }
+        step = 0;
+        fields = sscanf (line, "%d,%d,%d,%d", &x, &y, &z, &step);
+        if (fields < 3)
+            continue;
+        if (num_samples == capacity)
+        {
+            capacity *= 2;
+            samples = realloc (samples, capacity * sizeof (hostSample_t));
+        }
+        samples[num_samples].x = (int16_t) x;
+        samples[num_samples].y = (int16_t) y;
+        samples[num_samples].z = (int16_t) z;
+        samples[num_samples].step = (uint8_t) (step != 0);
+        num_samples++;
+    }
+    fclose (fp);
+
+    base = strrchr (path, '/');
+    snprintf (name, sizeof (name), "%s", base ? base + 1 : path);
+    loaded = true;
+    return true;
+}
+
+/*********************************************************
+ * hostTraceLoad: opens HOST_TRACE, or falls back to a flat
+ * trace of the board lying still.
+ *********************************************************/
+void
+hostTraceLoad (void)
+{
+    const char *path;
+    uint32_t i;
+
+    if (loaded)
+        return;
+
+    path = getenv ("HOST_TRACE");
+    if (path != NULL)
+    {
+        if (!hostTraceOpen (path))
+        {
+            fprintf (stderr, "host: cannot read trace %s\n", path);
+            exit (2);
+        }
+        return;
+    }
+
+    num_samples = FLAT_TRACE_SECONDS * DEFAULT_RATE_HZ;
+    samples = calloc (num_samples, sizeof (hostSample_t));
+    for (i = 0; i < num_samples; i++)
+        samples[i].z = 256;
+    snprintf (name, sizeof (name), "(flat)");
+    loaded = true;
+}
+
+uint32_t
+hostTraceLength (void)
+{
+    return num_samples;
+}
+
+uint32_t
+hostTraceRateHz (void)
+{
+    return rate_hz;
+}
+
+const char *
+hostTraceName (void)
+{
+    return name;
+}
+
+const hostSample_t *
+hostTraceAt (uint32_t index)
+{
+    if (num_samples == 0)
+        return NULL;
+    if (index >= num_samples)
+        index = num_samples - 1;
+    return &samples[index];
+}
+
+uint32_t
+hostTraceIndexNow (void)
+{
+    return (uint32_t) (hostNow () * rate_hz / hostClockHz ());
+}
+
+bool
+hostTraceFinished (void)
+{
+    return hostTraceIndexNow () >= num_samples;
+}
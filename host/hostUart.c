@@ -0,0 +1,294 @@
+/**********************************************************
+ *
+ * hostUart.c
+ *
+ * Host model of UART0 transmit fed by uDMA channel 9. Only
+ * this channel is modelled. It supports basic and ping-pong
+ * modes. A transfer takes 10 bit times per byte at the
+ * configured baud rate. When it ends, its bytes are appended
+ * to the file named by HOST_UART (if set), its control
+ * structure reads back as UDMA_MODE_STOP, and INT_UART0 is
+ * raised. In ping-pong mode the other structure then starts
+ * if it is armed; otherwise the channel disables itself.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    10th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "hostHal.h"
+
+typedef struct {
+    uint32_t mode;
+    const uint8_t *src;
+    uint32_t size;
+} dmaStruct_t;
+
+/*******************************************
+ *      Globals to module
+ *******************************************/
+static uint32_t baud = 115200;
+static bool uart_enabled;
+static bool dma_tx;
+static bool channel_enabled;
+static bool use_alt;                    // UDMA_ATTR_ALTSELECT
+static uint8_t active;                  // 0 primary, 1 alternate
+static dmaStruct_t structs[2];
+static FILE *capture;
+static bool capture_opened;
+
+static uint32_t stat_bytes;
+static uint32_t stat_transfers;
+
+static void transferDone (void);
+static hostEvent_t done_event = {0, false, transferDone};
+
+static void
+checkUart (uint32_t base)
+{
+    if (base != UART0_BASE)
+    {
+        fprintf (stderr, "host: UART 0x%08x is not modelled\n", base);
+        exit (2);
+    }
+}
+
+static void
+checkChannel (uint32_t channel)
+{
+    if ((channel & 0x1F) != UDMA_CHANNEL_UART0TX)
+    {
+        fprintf (stderr, "host: uDMA channel %u is not modelled\n",
+                 channel & 0x1F);
+        exit (2);
+    }
+}
+
+static void
+startTransfer (void)
+{
+    uint64_t cycles;
+
+    cycles = (uint64_t) structs[active].size * 10 * hostClockHz () / baud;
+    hostEventArm (&done_event, hostNow () + cycles);
+}
+
+static void
+transferDone (void)
+{
+    dmaStruct_t *s = &structs[active];
+
+    if (!capture_opened)
+    {
+        const char *path = getenv ("HOST_UART");
+
+        capture_opened = true;
+        if (path != NULL && (capture = fopen (path, "wb")) == NULL)
+            fprintf (stderr, "host: cannot write %s\n", path);
+    }
+    if (capture != NULL)
+        fwrite (s->src, 1, s->size, capture);
+    stat_bytes += s->size;
+    stat_transfers++;
+
+    if (s->mode == UDMA_MODE_PINGPONG
+        && structs[active ^ 1].mode != UDMA_MODE_STOP)
+    {
+        s->mode = UDMA_MODE_STOP;
+        active ^= 1;
+        startTransfer ();
+    }
+    else
+    {
+        s->mode = UDMA_MODE_STOP;
+        channel_enabled = false;
+    }
+    hostRaise (INT_UART0);
+}
+
+void
+hostUartReport (void)
+{
+    if (capture != NULL)
+        fflush (capture);
+    if (stat_transfers > 0)
+        printf ("host: uart0 %u bytes in %u uDMA transfers at %u baud\n",
+                stat_bytes, stat_transfers, baud);
+}
+
+/*********************************************************
+ * driverlib UART API
+ *********************************************************/
+void
+UARTConfigSetExpClk (uint32_t ui32Base, uint32_t ui32UARTClk, uint32_t ui32Baud,
+                     uint32_t ui32Config)
+{
+    checkUart (ui32Base);
+    (void) ui32UARTClk;
+    (void) ui32Config;
+    baud = ui32Baud;
+}
+
+void
+UARTFIFOLevelSet (uint32_t ui32Base, uint32_t ui32TxLevel, uint32_t ui32RxLevel)
+{
+    checkUart (ui32Base);
+    (void) ui32TxLevel;
+    (void) ui32RxLevel;
+}
+
+void
+UARTEnable (uint32_t ui32Base)
+{
+    checkUart (ui32Base);
+    uart_enabled = true;
+}
+
+void
+UARTDisable (uint32_t ui32Base)
+{
+    checkUart (ui32Base);
+    uart_enabled = false;
+}
+
+void
+UARTDMAEnable (uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    checkUart (ui32Base);
+    if (ui32DMAFlags & UART_DMA_TX)
+        dma_tx = true;
+}
+
+void
+UARTDMADisable (uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    checkUart (ui32Base);
+    if (ui32DMAFlags & UART_DMA_TX)
+        dma_tx = false;
+}
+
+uint32_t
+UARTIntStatus (uint32_t ui32Base, bool bMasked)
+{
+    checkUart (ui32Base);
+    (void) bMasked;
+    return 0;                   // Only the uDMA done interrupt is modelled
+}
+
+void
+UARTIntClear (uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    checkUart (ui32Base);
+    (void) ui32IntFlags;
+}
+
+bool
+UARTBusy (uint32_t ui32Base)
+{
+    checkUart (ui32Base);
+    return channel_enabled;
+}
+
+/*********************************************************
+ * driverlib uDMA API
+ *********************************************************/
+void
+uDMAEnable (void)
+{
+}
+
+void
+uDMAControlBaseSet (void *pControlTable)
+{
+    if (((uintptr_t) pControlTable & 0x3FF) != 0)
+    {
+        fprintf (stderr, "host: uDMA control table not 1024 byte aligned\n");
+        exit (2);
+    }
+}
+
+void
+uDMAChannelAssign (uint32_t ui32Mapping)
+{
+    checkChannel (ui32Mapping);
+}
+
+void
+uDMAChannelAttributeEnable (uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+    checkChannel (ui32ChannelNum);
+    if (ui32Attr & UDMA_ATTR_ALTSELECT)
+        use_alt = true;
+}
+
+void
+uDMAChannelAttributeDisable (uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+    checkChannel (ui32ChannelNum);
+    if (ui32Attr & UDMA_ATTR_ALTSELECT)
+        use_alt = false;
+}
+
+void
+uDMAChannelControlSet (uint32_t ui32ChannelStructIndex, uint32_t ui32Control)
+{
+    checkChannel (ui32ChannelStructIndex);
+    (void) ui32Control;         // Always bytes, source incrementing
+}
+
+void
+uDMAChannelTransferSet (uint32_t ui32ChannelStructIndex, uint32_t ui32Mode,
+                        void *pvSrcAddr, void *pvDstAddr,
+                        uint32_t ui32TransferSize)
+{
+    dmaStruct_t *s = &structs[(ui32ChannelStructIndex & UDMA_ALT_SELECT) != 0];
+
+    checkChannel (ui32ChannelStructIndex);
+    (void) pvDstAddr;
+    s->mode = ui32Mode;
+    s->src = pvSrcAddr;
+    s->size = ui32TransferSize;
+}
+
+void
+uDMAChannelEnable (uint32_t ui32ChannelNum)
+{
+    checkChannel (ui32ChannelNum);
+    if (channel_enabled || !uart_enabled || !dma_tx)
+        return;
+    active = use_alt;
+    if (structs[active].mode == UDMA_MODE_STOP)
+        return;
+    channel_enabled = true;
+    startTransfer ();
+}
+
+void
+uDMAChannelDisable (uint32_t ui32ChannelNum)
+{
+    checkChannel (ui32ChannelNum);
+    channel_enabled = false;
+    hostEventCancel (&done_event);
+}
+
+bool
+uDMAChannelIsEnabled (uint32_t ui32ChannelNum)
+{
+    checkChannel (ui32ChannelNum);
+    return channel_enabled;
+}
+
+uint32_t
+uDMAChannelModeGet (uint32_t ui32ChannelStructIndex)
+{
+    checkChannel (ui32ChannelStructIndex);
+    return structs[(ui32ChannelStructIndex & UDMA_ALT_SELECT) != 0].mode;
+}
@@ -0,0 +1,33 @@
+/**********************************************************
+ *
+ * hostUstdlib.c
+ *
+ * usnprintf/uvsnprintf for the host build, forwarded to the
+ * C library.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    8th of April 2022
+ *
+ **********************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "utils/ustdlib.h"
+
+int
+uvsnprintf (char *s, size_t n, const char *format, va_list arg)
+{
+    return vsnprintf (s, n, format, arg);
+}
+
+int
+usnprintf (char *s, size_t n, const char *format, ...)
+{
+    va_list arg;
+    int len;
+
+    va_start (arg, format);
+    len = uvsnprintf (s, n, format, arg);
+    va_end (arg);
+    return len;
+}
@@ -0,0 +1,45 @@
+/**********************************************************
+ *
+ * hostVectors.c
+ *
+ * Host copy of the interrupt vector table. Entries must be
+ * kept in step with g_pfnVectors in
+ * tm4c123gh6pm_startup_ccs.c. Handlers are referenced weakly
+ * so host tools that link only part of the firmware still
+ * build.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    11th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "inc/hw_ints.h"
+#include "hostHal.h"
+
+extern void SysTickIntHandler (void) __attribute__ ((weak));
+extern void I2C0IntHandler (void) __attribute__ ((weak));
+extern void GPIOPortDIntHandler (void) __attribute__ ((weak));
+extern void GPIOPortEIntHandler (void) __attribute__ ((weak));
+extern void GPIOPortFIntHandler (void) __attribute__ ((weak));
+extern void UART0IntHandler (void) __attribute__ ((weak));
+extern void Timer0AIntHandler (void) __attribute__ ((weak));
+
+static const hostVector_t vectors[NUM_INTERRUPTS] = {
+    [FAULT_SYSTICK] = SysTickIntHandler,
+    [INT_GPIOD] = GPIOPortDIntHandler,
+    [INT_GPIOE] = GPIOPortEIntHandler,
+    [INT_UART0] = UART0IntHandler,
+    [INT_I2C0] = I2C0IntHandler,
+    [INT_TIMER0A] = Timer0AIntHandler,
+    [INT_GPIOF] = GPIOPortFIntHandler,
+};
+
+hostVector_t
+hostVector (uint32_t vector)
+{
+    if (vector >= NUM_INTERRUPTS)
+        return NULL;
+    return vectors[vector];
+}
@@ -0,0 +1,14 @@
+//*****************************************************************************
+//
+// debug.h - Host stand-in for the TivaWare debug macros.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_DEBUG_H__
+#define __DRIVERLIB_DEBUG_H__
+
+#include <assert.h>
+
+#define ASSERT(expr)            assert (expr)
+
+#endif // __DRIVERLIB_DEBUG_H__
@@ -0,0 +1,22 @@
+//*****************************************************************************
+//
+// eeprom.h - Host stand-in for the TivaWare EEPROM API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_EEPROM_H__
+#define __DRIVERLIB_EEPROM_H__
+
+#include <stdint.h>
+
+#define EEPROM_INIT_OK          0
+#define EEPROM_INIT_ERROR       2
+
+extern uint32_t EEPROMInit (void);
+extern uint32_t EEPROMSizeGet (void);
+extern void EEPROMRead (uint32_t *pui32Data, uint32_t ui32Address,
+                        uint32_t ui32Count);
+extern uint32_t EEPROMProgram (uint32_t *pui32Data, uint32_t ui32Address,
+                               uint32_t ui32Count);
+
+#endif // __DRIVERLIB_EEPROM_H__
@@ -0,0 +1,20 @@
+//*****************************************************************************
+//
+// flash.h - Host stand-in for the TivaWare flash API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_FLASH_H__
+#define __DRIVERLIB_FLASH_H__
+
+#include <stdint.h>
+
+extern int32_t FlashErase (uint32_t ui32Address);
+extern int32_t FlashProgram (uint32_t *pui32Data, uint32_t ui32Address,
+                             uint32_t ui32Count);
+
+// Host only: the emulated flash is not at its target address, so the
+// firmware reads it through here (see hostFlash.c).
+extern const uint32_t *hostFlashAt (uint32_t ui32Address);
+
+#endif // __DRIVERLIB_FLASH_H__
@@ -0,0 +1,63 @@
+//*****************************************************************************
+//
+// gpio.h - Host stand-in for the TivaWare GPIO API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_GPIO_H__
+#define __DRIVERLIB_GPIO_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GPIO_PIN_0              0x00000001
+#define GPIO_PIN_1              0x00000002
+#define GPIO_PIN_2              0x00000004
+#define GPIO_PIN_3              0x00000008
+#define GPIO_PIN_4              0x00000010
+#define GPIO_PIN_5              0x00000020
+#define GPIO_PIN_6              0x00000040
+#define GPIO_PIN_7              0x00000080
+
+#define GPIO_FALLING_EDGE       0x00000000
+#define GPIO_RISING_EDGE        0x00000004
+#define GPIO_BOTH_EDGES         0x00000001
+#define GPIO_LOW_LEVEL          0x00000002
+#define GPIO_HIGH_LEVEL         0x00000006
+
+#define GPIO_INT_PIN_0          0x00000001
+#define GPIO_INT_PIN_1          0x00000002
+#define GPIO_INT_PIN_2          0x00000004
+#define GPIO_INT_PIN_3          0x00000008
+#define GPIO_INT_PIN_4          0x00000010
+#define GPIO_INT_PIN_5          0x00000020
+#define GPIO_INT_PIN_6          0x00000040
+#define GPIO_INT_PIN_7          0x00000080
+
+#define GPIO_STRENGTH_2MA       0x00000001
+#define GPIO_STRENGTH_4MA       0x00000002
+#define GPIO_STRENGTH_8MA       0x00000066
+
+#define GPIO_PIN_TYPE_STD       0x00000008
+#define GPIO_PIN_TYPE_STD_WPU   0x0000000A
+#define GPIO_PIN_TYPE_STD_WPD   0x0000000C
+#define GPIO_PIN_TYPE_OD        0x00000009
+
+extern void GPIOPinTypeGPIOInput (uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinTypeGPIOOutput (uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinTypeI2C (uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinTypeI2CSCL (uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinTypeUART (uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinConfigure (uint32_t ui32PinConfig);
+extern void GPIOPadConfigSet (uint32_t ui32Port, uint8_t ui8Pins,
+                              uint32_t ui32Strength, uint32_t ui32PadType);
+extern int32_t GPIOPinRead (uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinWrite (uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val);
+extern void GPIOIntTypeSet (uint32_t ui32Port, uint8_t ui8Pins,
+                            uint32_t ui32IntType);
+extern void GPIOIntEnable (uint32_t ui32Port, uint32_t ui32IntFlags);
+extern void GPIOIntDisable (uint32_t ui32Port, uint32_t ui32IntFlags);
+extern uint32_t GPIOIntStatus (uint32_t ui32Port, bool bMasked);
+extern void GPIOIntClear (uint32_t ui32Port, uint32_t ui32IntFlags);
+
+#endif // __DRIVERLIB_GPIO_H__
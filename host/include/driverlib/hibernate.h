@@ -0,0 +1,22 @@
+//*****************************************************************************
+//
+// hibernate.h - Host stand-in for the TivaWare hibernation module API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_HIBERNATE_H__
+#define __DRIVERLIB_HIBERNATE_H__
+
+#include <stdint.h>
+
+#define HIBERNATE_OSC_LFIOSC    0x00080000
+#define HIBERNATE_OSC_LOWDRIVE  0x00000000
+#define HIBERNATE_OSC_HIGHDRIVE 0x00020000
+#define HIBERNATE_OSC_DISABLE   0x00010000
+
+extern void HibernateEnableExpClk (uint32_t ui32HibClk);
+extern void HibernateClockConfig (uint32_t ui32Config);
+extern void HibernateRTCEnable (void);
+extern uint32_t HibernateRTCGet (void);
+
+#endif // __DRIVERLIB_HIBERNATE_H__
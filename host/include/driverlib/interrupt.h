@@ -0,0 +1,22 @@
+//*****************************************************************************
+//
+// interrupt.h - Host stand-in for the TivaWare NVIC API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_INTERRUPT_H__
+#define __DRIVERLIB_INTERRUPT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern bool IntMasterEnable (void);
+extern bool IntMasterDisable (void);
+extern void IntEnable (uint32_t ui32Interrupt);
+extern void IntDisable (uint32_t ui32Interrupt);
+extern bool IntIsEnabled (uint32_t ui32Interrupt);
+extern void IntPrioritySet (uint32_t ui32Interrupt, uint8_t ui8Priority);
+extern void IntPendSet (uint32_t ui32Interrupt);
+extern void IntPendClear (uint32_t ui32Interrupt);
+
+#endif // __DRIVERLIB_INTERRUPT_H__
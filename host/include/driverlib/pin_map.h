@@ -0,0 +1,15 @@
+//*****************************************************************************
+//
+// pin_map.h - Host stand-in for the TivaWare pin mapping definitions.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_PIN_MAP_H__
+#define __DRIVERLIB_PIN_MAP_H__
+
+#define GPIO_PA0_U0RX           0x00000001
+#define GPIO_PA1_U0TX           0x00000401
+#define GPIO_PB2_I2C0SCL        0x00010803
+#define GPIO_PB3_I2C0SDA        0x00010C03
+
+#endif // __DRIVERLIB_PIN_MAP_H__
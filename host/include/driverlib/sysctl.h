@@ -0,0 +1,63 @@
+//*****************************************************************************
+//
+// sysctl.h - Host stand-in for the TivaWare system control API.
+//
+// The SYSCTL_SYSDIV_x values encode the divisor directly (bits 23..28); they
+// are only meaningful to the host model in hostSysCtl.c.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_SYSCTL_H__
+#define __DRIVERLIB_SYSCTL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SYSCTL_PERIPH_GPIOA     0xf0000800
+#define SYSCTL_PERIPH_GPIOB     0xf0000801
+#define SYSCTL_PERIPH_GPIOC     0xf0000802
+#define SYSCTL_PERIPH_GPIOD     0xf0000803
+#define SYSCTL_PERIPH_GPIOE     0xf0000804
+#define SYSCTL_PERIPH_GPIOF     0xf0000805
+#define SYSCTL_PERIPH_I2C0      0xf0002000
+#define SYSCTL_PERIPH_TIMER0    0xf0000400
+#define SYSCTL_PERIPH_TIMER1    0xf0000401
+#define SYSCTL_PERIPH_UART0     0xf0001800
+#define SYSCTL_PERIPH_UDMA      0xf0000c00
+#define SYSCTL_PERIPH_EEPROM0   0xf0005800
+#define SYSCTL_PERIPH_HIBERNATE 0xf0001400
+
+#define SYSCTL_SYSDIV_1         0x00800000
+#define SYSCTL_SYSDIV_2         0x01000000
+#define SYSCTL_SYSDIV_4         0x02000000
+#define SYSCTL_SYSDIV_5         0x02800000
+#define SYSCTL_SYSDIV_8         0x04000000
+#define SYSCTL_SYSDIV_10        0x05000000
+#define SYSCTL_SYSDIV_16        0x08000000
+#define SYSCTL_SYSDIV_M         0x1F800000
+
+#define SYSCTL_USE_PLL          0x00000000
+#define SYSCTL_USE_OSC          0x00003800
+#define SYSCTL_OSC_MAIN         0x00000000
+#define SYSCTL_XTAL_16MHZ       0x00000540
+
+#define SYSCTL_DSLP_DIV_1       0x00000000
+#define SYSCTL_DSLP_OSC_MAIN    0x00000000
+#define SYSCTL_DSLP_OSC_INT     0x00000010
+#define SYSCTL_DSLP_OSC_INT30   0x00000030
+#define SYSCTL_DSLP_PIOSC_PD    0x00000002
+
+extern void SysCtlClockSet (uint32_t ui32Config);
+extern uint32_t SysCtlClockGet (void);
+extern void SysCtlDelay (uint32_t ui32Count);
+extern void SysCtlPeripheralEnable (uint32_t ui32Peripheral);
+extern void SysCtlPeripheralReset (uint32_t ui32Peripheral);
+extern bool SysCtlPeripheralReady (uint32_t ui32Peripheral);
+extern void SysCtlSleep (void);
+extern void SysCtlDeepSleep (void);
+extern void SysCtlDeepSleepClockSet (uint32_t ui32Config);
+extern void SysCtlPeripheralSleepEnable (uint32_t ui32Peripheral);
+extern void SysCtlPeripheralDeepSleepEnable (uint32_t ui32Peripheral);
+extern void SysCtlPeripheralClockGating (bool bEnable);
+
+#endif // __DRIVERLIB_SYSCTL_H__
@@ -0,0 +1,20 @@
+//*****************************************************************************
+//
+// systick.h - Host stand-in for the TivaWare SysTick API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_SYSTICK_H__
+#define __DRIVERLIB_SYSTICK_H__
+
+#include <stdint.h>
+
+extern void SysTickEnable (void);
+extern void SysTickDisable (void);
+extern void SysTickIntEnable (void);
+extern void SysTickIntDisable (void);
+extern void SysTickPeriodSet (uint32_t ui32Period);
+extern uint32_t SysTickPeriodGet (void);
+extern uint32_t SysTickValueGet (void);
+
+#endif // __DRIVERLIB_SYSTICK_H__
@@ -0,0 +1,35 @@
+//*****************************************************************************
+//
+// timer.h - Host stand-in for the TivaWare general purpose timer API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_TIMER_H__
+#define __DRIVERLIB_TIMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TIMER_CFG_ONE_SHOT      0x00000021
+#define TIMER_CFG_ONE_SHOT_UP   0x00000031
+#define TIMER_CFG_PERIODIC      0x00000022
+#define TIMER_CFG_PERIODIC_UP   0x00000032
+
+#define TIMER_A                 0x000000FF
+#define TIMER_B                 0x0000FF00
+#define TIMER_BOTH              0x0000FFFF
+
+#define TIMER_TIMA_TIMEOUT      0x00000001
+
+extern void TimerConfigure (uint32_t ui32Base, uint32_t ui32Config);
+extern void TimerEnable (uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerDisable (uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerLoadSet (uint32_t ui32Base, uint32_t ui32Timer,
+                          uint32_t ui32Value);
+extern uint32_t TimerValueGet (uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerIntEnable (uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void TimerIntDisable (uint32_t ui32Base, uint32_t ui32IntFlags);
+extern uint32_t TimerIntStatus (uint32_t ui32Base, bool bMasked);
+extern void TimerIntClear (uint32_t ui32Base, uint32_t ui32IntFlags);
+
+#endif // __DRIVERLIB_TIMER_H__
@@ -0,0 +1,35 @@
+//*****************************************************************************
+//
+// uart.h - Host stand-in for the TivaWare UART API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_UART_H__
+#define __DRIVERLIB_UART_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define UART_CONFIG_WLEN_8      0x00000060
+#define UART_CONFIG_STOP_ONE    0x00000000
+#define UART_CONFIG_PAR_NONE    0x00000000
+
+#define UART_FIFO_TX4_8         0x00000002
+#define UART_FIFO_RX4_8         0x00000010
+
+#define UART_DMA_TX             0x00000002
+#define UART_DMA_RX             0x00000001
+
+extern void UARTConfigSetExpClk (uint32_t ui32Base, uint32_t ui32UARTClk,
+                                 uint32_t ui32Baud, uint32_t ui32Config);
+extern void UARTFIFOLevelSet (uint32_t ui32Base, uint32_t ui32TxLevel,
+                              uint32_t ui32RxLevel);
+extern void UARTEnable (uint32_t ui32Base);
+extern void UARTDisable (uint32_t ui32Base);
+extern void UARTDMAEnable (uint32_t ui32Base, uint32_t ui32DMAFlags);
+extern void UARTDMADisable (uint32_t ui32Base, uint32_t ui32DMAFlags);
+extern uint32_t UARTIntStatus (uint32_t ui32Base, bool bMasked);
+extern void UARTIntClear (uint32_t ui32Base, uint32_t ui32IntFlags);
+extern bool UARTBusy (uint32_t ui32Base);
+
+#endif // __DRIVERLIB_UART_H__
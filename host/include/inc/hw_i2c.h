@@ -0,0 +1,13 @@
+//*****************************************************************************
+//
+// hw_i2c.h - Host stand-in for the TivaWare I2C register definitions.
+//
+// The I2C0 model in hostI2c.c is driven entirely through the driverlib
+// calls in driverlib/i2c.h, so no raw register offsets are needed.
+//
+//*****************************************************************************
+
+#ifndef __HW_I2C_H__
+#define __HW_I2C_H__
+
+#endif // __HW_I2C_H__
@@ -0,0 +1,26 @@
+//*****************************************************************************
+//
+// hw_ints.h - Host stand-in for the TivaWare interrupt assignments.
+//
+// Vector numbers match the TM4C123GH6PM vector table.
+//
+//*****************************************************************************
+
+#ifndef __HW_INTS_H__
+#define __HW_INTS_H__
+
+#define FAULT_SYSTICK           15          // System Tick
+#define INT_GPIOA               16          // GPIO Port A
+#define INT_GPIOB               17          // GPIO Port B
+#define INT_GPIOC               18          // GPIO Port C
+#define INT_GPIOD               19          // GPIO Port D
+#define INT_GPIOE               20          // GPIO Port E
+#define INT_UART0               21          // UART0
+#define INT_I2C0                24          // I2C0 Master and Slave
+#define INT_TIMER0A             35          // 16/32-Bit Timer 0A
+#define INT_TIMER1A             37          // 16/32-Bit Timer 1A
+#define INT_GPIOF               46          // GPIO Port F
+
+#define NUM_INTERRUPTS          155
+
+#endif // __HW_INTS_H__
@@ -0,0 +1,30 @@
+//*****************************************************************************
+//
+// hw_memmap.h - Host stand-in for the TivaWare memory map definitions.
+//
+// Only the base addresses used by the pedometer firmware are listed. The
+// values match the TM4C123GH6PM so HWREG() accesses land on the same
+// (emulated) register as on target.
+//
+//*****************************************************************************
+
+#ifndef __HW_MEMMAP_H__
+#define __HW_MEMMAP_H__
+
+#define FLASH_BASE              0x00000000
+#define SRAM_BASE               0x20000000
+#define GPIO_PORTA_BASE         0x40004000
+#define UART0_BASE              0x4000C000
+#define GPIO_PORTB_BASE         0x40005000
+#define GPIO_PORTC_BASE         0x40006000
+#define GPIO_PORTD_BASE         0x40007000
+#define I2C0_BASE               0x40020000
+#define GPIO_PORTE_BASE         0x40024000
+#define GPIO_PORTF_BASE         0x40025000
+#define TIMER0_BASE             0x40030000
+#define TIMER1_BASE             0x40031000
+#define SYSCTL_BASE             0x400FE000
+#define UDMA_BASE               0x400FF000
+#define NVIC_BASE               0xE000E000
+
+#endif // __HW_MEMMAP_H__
@@ -0,0 +1,21 @@
+//*****************************************************************************
+//
+// hw_types.h - Host stand-in for the TivaWare common types and macros.
+//
+// HWREG() and friends are routed through hostReg() so that direct register
+// accesses in the firmware hit the emulated register map instead of
+// dereferencing a peripheral address on the workstation.
+//
+//*****************************************************************************
+
+#ifndef __HW_TYPES_H__
+#define __HW_TYPES_H__
+
+#include <stdint.h>
+#include "../../hostHal.h"
+
+#define HWREG(x)                (*hostReg ((uint32_t)(x)))
+#define HWREGH(x)               (*(volatile uint16_t *)hostReg ((uint32_t)(x)))
+#define HWREGB(x)               (*(volatile uint8_t *)hostReg ((uint32_t)(x)))
+
+#endif // __HW_TYPES_H__
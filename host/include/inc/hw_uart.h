@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// hw_uart.h - Host stand-in for the TivaWare UART register definitions.
+//
+//*****************************************************************************
+
+#ifndef __HW_UART_H__
+#define __HW_UART_H__
+
+#define UART_O_DR               0x00000000  // Data register, the uDMA target
+
+#endif // __HW_UART_H__
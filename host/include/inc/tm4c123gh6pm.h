@@ -0,0 +1,20 @@
+//*****************************************************************************
+//
+// tm4c123gh6pm.h - Host stand-in for the TM4C123GH6PM register definitions.
+//
+// Only the registers touched directly by the firmware are provided.
+//
+//*****************************************************************************
+
+#ifndef __TM4C123GH6PM_H__
+#define __TM4C123GH6PM_H__
+
+#include "hw_types.h"
+
+#define GPIO_PORTF_LOCK_R       HWREG(0x40025520)
+#define GPIO_PORTF_CR_R         HWREG(0x40025524)
+
+#define GPIO_LOCK_M             0xFFFFFFFF  // GPIO Lock
+#define GPIO_LOCK_KEY           0x4C4F434B  // Unlocks the GPIO_CR register
+
+#endif // __TM4C123GH6PM_H__
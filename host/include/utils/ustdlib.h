@@ -0,0 +1,16 @@
+//*****************************************************************************
+//
+// ustdlib.h - Host stand-in for the TivaWare small-footprint stdlib.
+//
+//*****************************************************************************
+
+#ifndef __USTDLIB_H__
+#define __USTDLIB_H__
+
+#include <stdarg.h>
+#include <stddef.h>
+
+extern int usnprintf (char *s, size_t n, const char *format, ...);
+extern int uvsnprintf (char *s, size_t n, const char *format, va_list arg);
+
+#endif // __USTDLIB_H__
@@ -0,0 +1,196 @@
+/**********************************************************
+ *
+ * logBench.c
+ *
+ * Host benchmark and recovery test for the flash step log
+ * (stepLog.c), run against the RAM flash model in
+ * hostFlash.c.
+ *
+ *   append     time per record, flash words and erases per
+ *              record, with the log wrapping several times
+ *   recovery   time for initStepLog() to find the end of a
+ *              full log
+ *   power cut  the power is cut after every possible number
+ *              of flash words during a run of appends. After
+ *              each cut the log must recover to a state
+ *              that was committed (the torn record may be
+ *              there or not), and take further appends.
+ *
+ *     make log-bench
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    9th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+#include "stepLog.h"
+#include "hostFlash.h"
+
+#define APPEND_RECORDS  20000
+#define RECOVERY_RUNS   200
+#define CUT_RECORDS     300     // Appends per power cut run, enough to rotate
+
+static uint64_t
+wallNs (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// A walking day: minutes of 0..150 steps, some longer gaps.
+static void
+record (uint32_t i, uint32_t *seconds, uint32_t *steps)
+{
+    uint32_t r = i * 2654435761u;
+
+    *seconds = (r >> 28) == 0 ? 60 + (r >> 12) % 3600 : 60;
+    *steps = (r >> 8) % 151;
+}
+
+typedef struct {
+    uint32_t records;
+    uint32_t seconds;
+    uint32_t steps;
+    bool ordered;
+} walk_t;
+
+static void
+visit (uint8_t type, uint32_t seconds, uint32_t steps, void *arg)
+{
+    walk_t *walk = arg;
+
+    if (walk->records > 0 && (seconds < walk->seconds || steps < walk->steps))
+        walk->ordered = false;
+    walk->records++;
+    walk->seconds = seconds;
+    walk->steps = steps;
+    (void) type;
+}
+
+static void
+benchAppend (void)
+{
+    hostFlashStats_t flash;
+    stepLogStats_t log;
+    walk_t walk = {0, 0, 0, true};
+    uint32_t i, seconds, steps, total = 0;
+    uint64_t start, ns;
+
+    hostFlashReset ();
+    initStepLog ();
+    start = wallNs ();
+    for (i = 0; i < APPEND_RECORDS; i++)
+    {
+        record (i, &seconds, &steps);
+        stepLogAppend (seconds, steps);
+        total += steps;
+    }
+    ns = wallNs () - start;
+    hostFlashGetStats (&flash);
+    stepLogGetStats (&log);
+    stepLogForEach (visit, &walk);
+
+    printf ("append    %u records, %.1f ns each, %.2f words and %.4f erases"
+            " per record\n", APPEND_RECORDS, (double) ns / APPEND_RECORDS,
+            (double) flash.words / APPEND_RECORDS,
+            (double) flash.erases / APPEND_RECORDS);
+    printf ("          %u records kept in %u sectors (%.1f bytes each),"
+            " sector %u sequence %u\n", walk.records, STEPLOG_SECTORS,
+            (STEPLOG_SECTORS * STEPLOG_SECTOR_SIZE) / (double) walk.records,
+            log.sector, log.sequence);
+    printf ("          totals %s, records %s\n",
+            stepLogSteps () == total && walk.steps == total ? "match" : "WRONG",
+            walk.ordered ? "in order" : "OUT OF ORDER");
+}
+
+static void
+benchRecovery (void)
+{
+    stepLogStats_t log;
+    uint64_t start, ns;
+    uint32_t run;
+
+    // The log from benchAppend(), full and wrapped. Each initStepLog()
+    // adds a boot record, as a reset would.
+    start = wallNs ();
+    for (run = 0; run < RECOVERY_RUNS; run++)
+        initStepLog ();
+    ns = wallNs () - start;
+    stepLogGetStats (&log);
+    printf ("recovery  %.0f ns per initStepLog(), %u records in the newest"
+            " sector\n", (double) ns / RECOVERY_RUNS, log.records);
+}
+
+static void
+benchPowerCut (void)
+{
+    hostFlashStats_t flash;
+    stepLogStats_t log;
+    uint32_t committed[CUT_RECORDS + 1];
+    uint32_t cut, words, i, seconds, steps, done;
+    uint32_t good = 0, torn_seen = 0, failed = 0;
+
+    // Words used by a complete run, and the totals after each append
+    hostFlashReset ();
+    initStepLog ();
+    committed[0] = 0;
+    for (i = 0; i < CUT_RECORDS; i++)
+    {
+        record (i, &seconds, &steps);
+        stepLogAppend (seconds, steps);
+        committed[i + 1] = stepLogSteps ();
+    }
+    hostFlashGetStats (&flash);
+    words = flash.words + flash.erases;
+
+    for (cut = 0; cut < words; cut++)
+    {
+        hostFlashReset ();
+        hostFlashCutAfter (cut);
+        initStepLog ();
+        for (done = 0; done < CUT_RECORDS; done++)
+        {
+            record (done, &seconds, &steps);
+            if (!stepLogAppend (seconds, steps))
+                break;
+        }
+
+        hostFlashPowerOn ();
+        if (!initStepLog ())
+        {
+            failed++;
+            continue;
+        }
+        // Either the record being written made it or it did not
+        steps = stepLogSteps ();
+        if (steps != committed[done]
+            && (done == CUT_RECORDS || steps != committed[done + 1]))
+        {
+            failed++;
+            continue;
+        }
+        stepLogGetStats (&log);
+        torn_seen += log.torn > 0;
+        if (stepLogAppend (60, 1) && initStepLog () && stepLogSteps () == steps + 1)
+            good++;
+        else
+            failed++;
+    }
+    printf ("power cut %u cut points, %u recovered, %u with a torn record,"
+            " %u FAILED\n", words, good, torn_seen, failed);
+}
+
+int
+main (void)
+{
+    benchAppend ();
+    benchRecovery ();
+    benchPowerCut ();
+    return 0;
+}
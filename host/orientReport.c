@@ -0,0 +1,296 @@
+/**********************************************************
+ *
+ * orientReport.c
+ *
+ * Accuracy and speed report for the integer orientation
+ * code in orientFixed.c. Each sample is compared with:
+ *
+ *  - the exact angle, from double precision atan2 on the
+ *    same integer sample, in centidegrees; and
+ *  - the exact angle rounded to whole degrees, counting
+ *    samples that would be displayed wrongly; and
+ *  - the displayed value of the old double precision
+ *    calcPitch()/calcRoll() (57.3 deg/rad, truncated to
+ *    whole degrees), counting samples whose shown degree
+ *    changes.
+ *
+ * The samples come from a sweep of the sphere at several
+ * magnitudes, plus every sample of any traces named on
+ * the command line:
+ *
+ *     make orient-report
+ *     ./build/orientReport traces/walking.csv
+ *
+ * The lookup tables in trigLut.c, which orientFixed.c is
+ * built on, are checked on their own first.
+ *
+ * Host timings are only a relative guide. The target has
+ * no double precision FPU, so the gap there is far wider.
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    22nd of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "orientFixed.h"
+#include "trigLut.h"
+
+#define SWEEP_STEP_DEG  1.0
+#define TIMING_ROUNDS   20
+#define MAX_SAMPLES     400000
+
+typedef struct {
+    const char *name;
+    uint32_t count;
+    double max_err;             // centidegrees
+    double sum_sq_err;
+    uint32_t shown_wrong;       // displayed degree is not the exact one, rounded
+    uint32_t shown_diff;        // displayed degree differs from the old code
+    int16_t worst_angle;        // exact angle at max_err, centidegrees
+} stats_t;
+
+static vector3_t samples[MAX_SAMPLES];
+static uint32_t num_samples;
+
+/*********************************************************
+ * The calculation replaced by orientFixed.c
+ *********************************************************/
+static int8_t
+oldPitch (vector3_t a)
+{
+    return atan2 (a.y, sqrt (pow (a.x, 2) + pow (a.z, 2))) * 57.3;
+}
+
+static int8_t
+oldRoll (vector3_t a)
+{
+    return atan2 (-a.x, a.z) * 57.3;
+}
+
+static uint64_t
+wallNs (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void
+addSample (int32_t x, int32_t y, int32_t z)
+{
+    if (num_samples == MAX_SAMPLES)
+        return;
+    samples[num_samples].x = x;
+    samples[num_samples].y = y;
+    samples[num_samples].z = z;
+    num_samples++;
+}
+
+/*********************************************************
+ * sweep: pitch and roll over the whole sphere at one
+ * magnitude, in counts.
+ *********************************************************/
+static void
+sweep (double magnitude)
+{
+    double pitch, roll;
+    double p, r;
+
+    for (pitch = -90.0; pitch <= 90.0; pitch += SWEEP_STEP_DEG)
+        for (roll = -180.0; roll < 180.0; roll += SWEEP_STEP_DEG)
+        {
+            p = pitch * M_PI / 180.0;
+            r = roll * M_PI / 180.0;
+            addSample (lround (-sin (r) * cos (p) * magnitude),
+                       lround (sin (p) * magnitude),
+                       lround (cos (r) * cos (p) * magnitude));
+        }
+}
+
+static uint32_t
+loadTrace (const char *path)
+{
+    FILE *fp = fopen (path, "r");
+    char line[128];
+    int x, y, z;
+    uint32_t start = num_samples;
+
+    if (fp == NULL)
+    {
+        fprintf (stderr, "orientReport: cannot read %s\n", path);
+        return 0;
+    }
+    while (fgets (line, sizeof (line), fp) != NULL)
+        if (line[0] != '#' && sscanf (line, "%d,%d,%d", &x, &y, &z) == 3)
+            addSample (x, y, z);
+    fclose (fp);
+    return num_samples - start;
+}
+
+static void
+account (stats_t *s, int16_t fixed, double exact, int16_t shown, int8_t old)
+{
+    double err = fabs (fixed - exact);
+
+    s->count++;
+    s->sum_sq_err += err * err;
+    if (err > s->max_err)
+    {
+        s->max_err = err;
+        s->worst_angle = lround (exact);
+    }
+    if (shown != lround (exact / 100.0))
+        s->shown_wrong++;
+    if (shown != old)
+        s->shown_diff++;
+}
+
+static void
+printStats (const char *set, const stats_t *s)
+{
+    uint32_t count = s->count ? s->count : 1;
+
+    printf ("  %-12s %-5s %7u  %5.1f  %5.2f  %6.2f%%  %6.2f%%  %7.2f\n",
+            set, s->name, s->count, s->max_err,
+            sqrt (s->sum_sq_err / count),
+            100.0 * s->shown_wrong / count, 100.0 * s->shown_diff / count,
+            s->worst_angle / 100.0);
+}
+
+static void
+report (const char *set, uint32_t first, uint32_t last)
+{
+    stats_t pitch = {"pitch"};
+    stats_t roll = {"roll"};
+    uint32_t i;
+    vector3_t a;
+    double exact;
+
+    for (i = first; i < last; i++)
+    {
+        a = samples[i];
+        exact = atan2 (a.y, sqrt ((double) a.x * a.x + (double) a.z * a.z))
+                * 18000.0 / M_PI;
+        account (&pitch, pitchCentideg (a), exact,
+                 centidegToDeg (pitchCentideg (a)), oldPitch (a));
+        exact = atan2 (-a.x, a.z) * 18000.0 / M_PI;
+        account (&roll, rollCentideg (a), exact,
+                 centidegToDeg (rollCentideg (a)), oldRoll (a));
+    }
+    printStats (set, &pitch);
+    printStats (set, &roll);
+}
+
+/*********************************************************
+ * lutReport: worst errors of the table accessors, over
+ * every ratio num / den for a spread of den, and every x
+ * up to 2^22 then a geometric sweep to 2^32.
+ *********************************************************/
+static void
+lutReport (void)
+{
+    static const uint32_t dens[] = {1, 7, 64, 255, 1000, 4096, 32767, 65535};
+    double atan_err = 0, inv_err = 0, sqrt_rel = 0, sqrt_abs = 0;
+    double exact, err;
+    uint32_t d, num, x;
+    uint32_t step;
+
+    for (d = 0; d < sizeof (dens) / sizeof (dens[0]); d++)
+        for (num = 0; num <= dens[d]; num++)
+        {
+            exact = atan ((double) num / dens[d]) * 18000.0 / M_PI;
+            err = fabs (atanLutCentideg (num, dens[d]) - exact);
+            if (err > atan_err)
+                atan_err = err;
+        }
+    for (x = 1, step = 1; x != 0; x += step)
+    {
+        exact = 2147483648.0 / sqrt ((double) x);
+        err = fabs (invSqrtLut (x) - exact) / exact;
+        if (err > inv_err)
+            inv_err = err;
+        exact = sqrt ((double) x);
+        err = fabs (sqrtLut (x) - exact);
+        if (err > sqrt_abs && exact < 256)
+            sqrt_abs = err;
+        if (exact >= 256 && (err - 0.5) / exact > sqrt_rel)
+            sqrt_rel = (err - 0.5) / exact;   // Beyond rounding to counts
+        if (x >= (1u << 22))
+            step = x / 4093 + 1;
+        if (x + step < x)
+            break;
+    }
+    printf ("trigLut tables: atan max error %.3f centidegrees,"
+            " 1/sqrt %.4f%%,\n  sqrt %.4f%% plus"
+            " rounding (%.2f counts below 256)\n\n",
+            atan_err, 100.0 * inv_err, 100.0 * sqrt_rel, sqrt_abs);
+}
+
+/*********************************************************
+ * timing: ns per pitch + roll pair over all samples.
+ *********************************************************/
+static void
+timing (void)
+{
+    volatile int32_t sink = 0;
+    uint64_t start;
+    double fixed_ns, double_ns;
+    uint32_t round, i;
+
+    start = wallNs ();
+    for (round = 0; round < TIMING_ROUNDS; round++)
+        for (i = 0; i < num_samples; i++)
+            sink += pitchCentideg (samples[i]) + rollCentideg (samples[i]);
+    fixed_ns = (double) (wallNs () - start) / TIMING_ROUNDS / num_samples;
+
+    start = wallNs ();
+    for (round = 0; round < TIMING_ROUNDS; round++)
+        for (i = 0; i < num_samples; i++)
+            sink += oldPitch (samples[i]) + oldRoll (samples[i]);
+    double_ns = (double) (wallNs () - start) / TIMING_ROUNDS / num_samples;
+
+    printf ("\nhost time per pitch+roll: integer %.1f ns, double %.1f ns\n",
+            fixed_ns, double_ns);
+}
+
+int
+main (int argc, char **argv)
+{
+    static const double magnitudes[] = {64.0, 256.0, 1024.0, 4095.0};
+    char set[32];
+    uint32_t first;
+    uint8_t m;
+    int arg;
+
+    lutReport ();
+    printf ("orientFixed accuracy, errors in centidegrees against double atan2\n"
+            "  %-12s %-5s %7s  %5s  %5s  %7s  %7s  %7s\n",
+            "samples", "angle", "count", "max", "rms", "wrong", "vs old",
+            "worst@");
+    for (m = 0; m < sizeof (magnitudes) / sizeof (magnitudes[0]); m++)
+    {
+        first = num_samples;
+        sweep (magnitudes[m]);
+        snprintf (set, sizeof (set), "sweep %.0f", magnitudes[m]);
+        report (set, first, num_samples);
+    }
+    for (arg = 1; arg < argc; arg++)
+    {
+        first = num_samples;
+        if (loadTrace (argv[arg]) > 0)
+        {
+            snprintf (set, sizeof (set), "%.12s", argv[arg]);
+            report (set, first, num_samples);
+        }
+    }
+    printf ("\n'wrong': displayed degree is not the exact angle rounded.\n"
+            "'vs old': displayed degree changed from the old code, which\n"
+            "truncated and used 57.3 deg/rad.\n");
+    timing ();
+    return 0;
+}
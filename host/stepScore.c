@@ -0,0 +1,185 @@
+/**********************************************************
+ *
+ * stepScore.c
+ *
+ * Scores the step detector in stepDetect.c against the
+ * labelled traces (step column = 1 on each heel strike).
+ * Each detection is matched to the nearest unmatched label
+ * within STEP_MATCH_WINDOW samples. Unmatched detections
+ * count as false positives and unmatched labels as misses.
+ * The cost per sample is timed over repeated runs, in
+ * nanoseconds and, on x86, in TSC cycles.
+ *
+ *     make step-score
+ *     ./build/stepScore traces/walking.csv ...
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    25th of April 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC
+#endif
+#include "stepDetect.h"
+
+#define MAX_SAMPLES         200000
+#define STEP_MATCH_WINDOW   25      // Samples either side of a label
+#define TIMING_ROUNDS       200
+
+static vector3_t samples[MAX_SAMPLES];
+static bool labelled[MAX_SAMPLES];
+static bool detected[MAX_SAMPLES];
+static uint32_t num_samples;
+
+static uint64_t
+wallNs (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static bool
+loadTrace (const char *path)
+{
+    FILE *fp = fopen (path, "r");
+    char line[128];
+    int x, y, z, step;
+
+    if (fp == NULL)
+        return false;
+    num_samples = 0;
+    while (fgets (line, sizeof (line), fp) != NULL && num_samples < MAX_SAMPLES)
+    {
+        step = 0;
+        if (line[0] == '#' || sscanf (line, "%d,%d,%d,%d", &x, &y, &z, &step) < 3)
+            continue;
+        samples[num_samples].x = x;
+        samples[num_samples].y = y;
+        samples[num_samples].z = z;
+        labelled[num_samples] = (step != 0);
+        num_samples++;
+    }
+    fclose (fp);
+    return true;
+}
+
+/*********************************************************
+ * match: pairs each detection with the nearest free label,
+ * returning the number of pairs.
+ *********************************************************/
+static uint32_t
+match (void)
+{
+    static bool taken[MAX_SAMPLES];
+    uint32_t matched = 0;
+    uint32_t i;
+    int32_t d, j;
+
+    memset (taken, 0, sizeof (taken));
+    for (i = 0; i < num_samples; i++)
+    {
+        if (!detected[i])
+            continue;
+        for (d = 0; d <= STEP_MATCH_WINDOW; d++)
+        {
+            j = (int32_t) i - d;
+            if (j >= 0 && labelled[j] && !taken[j])
+                break;
+            j = (int32_t) i + d;
+            if (j < (int32_t) num_samples && labelled[j] && !taken[j])
+                break;
+        }
+        if (d <= STEP_MATCH_WINDOW)
+        {
+            taken[j] = true;
+            matched++;
+        }
+    }
+    return matched;
+}
+
+static void
+score (const char *path)
+{
+    stepDetect_t detector;
+    uint32_t labels = 0;
+    uint32_t matched;
+    uint32_t steps;
+    uint32_t round, i;
+    uint64_t start_ns, ns;
+#ifdef HAVE_TSC
+    uint64_t start_tsc, tsc = 0;
+#endif
+
+    initStepDetect (&detector);
+    for (i = 0; i < num_samples; i++)
+    {
+        detected[i] = updateStepDetect (&detector, samples[i]);
+        labels += labelled[i];
+    }
+    steps = getStepCount (&detector);
+    matched = match ();
+
+    start_ns = wallNs ();
+#ifdef HAVE_TSC
+    start_tsc = __rdtsc ();
+#endif
+    for (round = 0; round < TIMING_ROUNDS; round++)
+    {
+        initStepDetect (&detector);
+        for (i = 0; i < num_samples; i++)
+            updateStepDetect (&detector, samples[i]);
+    }
+#ifdef HAVE_TSC
+    tsc = __rdtsc () - start_tsc;
+#endif
+    ns = wallNs () - start_ns;
+    if (getStepCount (&detector) != steps)
+        printf ("  (timing run disagreed)\n");
+
+    printf ("  %-20s %6u %6u %6u %5u %5u  %6.1f%% %6.1f%% %+6.1f%%  %5.1f",
+            path, labels, steps, matched, steps - matched, labels - matched,
+            steps ? 100.0 * matched / steps : 100.0,
+            labels ? 100.0 * matched / labels : 100.0,
+            labels ? 100.0 * ((double) steps - labels) / labels : 0.0,
+            (double) ns / TIMING_ROUNDS / num_samples);
+#ifdef HAVE_TSC
+    printf ("  %6.1f", (double) tsc / TIMING_ROUNDS / num_samples);
+#endif
+    printf ("\n");
+}
+
+int
+main (int argc, char **argv)
+{
+    int arg;
+
+    printf ("step detector score, match window +/-%u samples\n"
+            "  %-20s %6s %6s %6s %5s %5s  %7s %7s %7s  %5s",
+            STEP_MATCH_WINDOW, "trace", "labels", "steps", "match", "fp",
+            "miss", "prec", "recall", "count", "ns/s");
+#ifdef HAVE_TSC
+    printf ("  %6s", "cyc/s");
+#endif
+    printf ("\n");
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (!loadTrace (argv[arg]))
+        {
+            fprintf (stderr, "stepScore: cannot read %s\n", argv[arg]);
+            return 1;
+        }
+        score (argv[arg]);
+    }
+    return 0;
+}
@@ -0,0 +1,265 @@
+/**********************************************************
+ *
+ * telemetryDecode.c
+ *
+ * Decodes and records the telemetry stream of telemetry.c,
+ * either from a capture file (HOST_UART in the host build)
+ * or live from the board's virtual COM port, which is set
+ * to raw mode at TELEM_BAUD. Each frame is COBS decoded and
+ * its CRC-8 checked; sequence gaps are counted as lost
+ * frames. Good frames are written, by type, to
+ *
+ *     <prefix>_raw.csv       x,y,z,step in the traces/ format,
+ *                            so a recording can be replayed
+ *     <prefix>_filtered.csv  mean x,y,z, pitch, roll
+ *     <prefix>_steps.csv     count, ms
+ *     <prefix>_profile.csv   stage, count, min, mean, max
+ *     <prefix>_batch.csv     time, samples, missed
+ *
+ * and a summary is printed at the end (or on Ctrl-C).
+ *
+ *     make telemetry
+ *     ./build/telemetryDecode [-o prefix] capture.bin
+ *     ./build/telemetryDecode -o walk /dev/ttyACM0
+ *
+ *    Ben Stewart and Daniel Pallesen
+ *    10th of May 2022
+ *
+ **********************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include "crc8.h"
+#include "telemetry.h"
+
+#define MAX_ENCODED         (TELEM_MAX_PAYLOAD + 4)
+
+static const char *const type_names[] = {
+    "?", "raw", "filtered", "steps", "profile", "batch"
+};
+
+static FILE *out[TELEM_BATCH + 1];
+static uint32_t frames[TELEM_BATCH + 1];
+static uint32_t bytes_in;
+static uint32_t crc_errors;
+static uint32_t framing_errors;
+static uint32_t lost;
+static bool have_seq;
+static uint8_t last_seq;
+static bool step_pending;
+static volatile sig_atomic_t stop;
+
+static void
+onSignal (int sig)
+{
+    (void) sig;
+    stop = 1;
+}
+
+// Decodes len bytes in place. Returns the decoded length, or -1.
+static int
+cobsDecode (uint8_t *buf, int len)
+{
+    int in = 0;
+    int out = 0;
+    uint8_t code;
+    uint8_t i;
+
+    while (in < len)
+    {
+        code = buf[in++];
+        if (code == 0 || in + code - 1 > len)
+            return -1;
+        for (i = 1; i < code; i++)
+            buf[out++] = buf[in++];
+        if (code < 0xFF && in < len)
+            buf[out++] = 0;
+    }
+    return out;
+}
+
+static int16_t
+get16 (const uint8_t *bytes)
+{
+    return (int16_t) (bytes[0] | bytes[1] << 8);
+}
+
+static uint32_t
+get32 (const uint8_t *bytes)
+{
+    return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+}
+
+static FILE *
+openCsv (const char *prefix, uint8_t type, const char *header)
+{
+    char path[256];
+    FILE *fp;
+
+    snprintf (path, sizeof (path), "%s_%s.csv", prefix, type_names[type]);
+    if ((fp = fopen (path, "w")) == NULL)
+    {
+        perror (path);
+        exit (1);
+    }
+    fputs (header, fp);
+    return fp;
+}
+
+static void
+handleFrame (uint8_t *frame, int len)
+{
+    const uint8_t *p = &frame[2];
+    uint8_t type;
+    uint8_t payload_len;
+
+    len = cobsDecode (frame, len);
+    if (len < 3)
+    {
+        framing_errors++;
+        return;
+    }
+    if (crc8 (frame, len - 1) != frame[len - 1])
+    {
+        crc_errors++;
+        return;
+    }
+    type = frame[0];
+    payload_len = len - 3;
+    if (have_seq)
+        lost += (uint8_t) (frame[1] - last_seq - 1);
+    have_seq = true;
+    last_seq = frame[1];
+
+    if (type == TELEM_RAW && payload_len == 6)
+    {
+        fprintf (out[type], "%d,%d,%d,%d\n", get16 (&p[0]), get16 (&p[2]),
+                 get16 (&p[4]), step_pending);
+        step_pending = false;
+    }
+    else if (type == TELEM_FILTERED && payload_len == 10)
+        fprintf (out[type], "%d,%d,%d,%d,%d\n", get16 (&p[0]), get16 (&p[2]),
+                 get16 (&p[4]), get16 (&p[6]), get16 (&p[8]));
+    else if (type == TELEM_STEP && payload_len == 8)
+    {
+        fprintf (out[type], "%u,%u\n", get32 (&p[0]), get32 (&p[4]));
+        step_pending = true;    // Sent just before the sample that made it
+    }
+    else if (type == TELEM_PROFILE && payload_len == 17)
+        fprintf (out[type], "%u,%u,%u,%u,%u\n", p[0], get32 (&p[1]),
+                 get32 (&p[5]), get32 (&p[9]), get32 (&p[13]));
+    else if (type == TELEM_BATCH && payload_len == 9)
+        fprintf (out[type], "%u,%u,%u\n", get32 (&p[0]), p[4], get32 (&p[5]));
+    else
+    {
+        framing_errors++;
+        return;
+    }
+    frames[type]++;
+}
+
+static void
+setRaw (int fd)
+{
+    struct termios tio;
+
+    if (tcgetattr (fd, &tio) != 0)
+        return;
+    cfmakeraw (&tio);
+    cfsetispeed (&tio, B115200);
+    cfsetospeed (&tio, B115200);
+    tcsetattr (fd, TCSANOW, &tio);
+}
+
+int
+main (int argc, char *argv[])
+{
+    const char *prefix = "telemetry";
+    const char *path;
+    uint8_t chunk[256];
+    uint8_t frame[MAX_ENCODED];
+    int frame_len = 0;
+    bool overlong = false;
+    bool synced = false;
+    ssize_t got;
+    ssize_t i;
+    uint8_t type;
+    int fd;
+
+    if (argc == 4 && strcmp (argv[1], "-o") == 0)
+    {
+        prefix = argv[2];
+        path = argv[3];
+    }
+    else if (argc == 2)
+        path = argv[1];
+    else
+    {
+        fprintf (stderr, "usage: %s [-o prefix] capture|tty\n", argv[0]);
+        return 1;
+    }
+    if ((fd = open (path, O_RDONLY | O_NOCTTY)) < 0)
+    {
+        perror (path);
+        return 1;
+    }
+    if (isatty (fd))
+    {
+        setRaw (fd);
+        synced = false;         // Joined mid-stream, skip to a delimiter
+    }
+    else
+        synced = true;
+    signal (SIGINT, onSignal);
+
+    out[TELEM_RAW] = openCsv (prefix, TELEM_RAW, "# rate_hz=100\n");
+    out[TELEM_FILTERED] = openCsv (prefix, TELEM_FILTERED,
+                                   "# mean_x,mean_y,mean_z,pitch,roll\n");
+    out[TELEM_STEP] = openCsv (prefix, TELEM_STEP, "# count,ms\n");
+    out[TELEM_PROFILE] = openCsv (prefix, TELEM_PROFILE,
+                                  "# stage,count,min,mean,max\n");
+    out[TELEM_BATCH] = openCsv (prefix, TELEM_BATCH,
+                                "# time_cycles,samples,missed\n");
+
+    while (!stop && (got = read (fd, chunk, sizeof (chunk))) > 0)
+    {
+        bytes_in += got;
+        for (i = 0; i < got; i++)
+        {
+            if (chunk[i] != 0)
+            {
+                if (frame_len < MAX_ENCODED)
+                    frame[frame_len++] = chunk[i];
+                else
+                    overlong = true;
+                continue;
+            }
+            if (!synced)
+                synced = true;
+            else if (overlong)
+                framing_errors++;
+            else if (frame_len > 0)
+                handleFrame (frame, frame_len);
+            frame_len = 0;
+            overlong = false;
+        }
+    }
+    close (fd);
+
+    printf ("telemetry: %u bytes, %u CRC errors, %u framing errors,"
+            " %u frames lost\n", bytes_in, crc_errors, framing_errors, lost);
+    for (type = TELEM_RAW; type <= TELEM_BATCH; type++)
+    {
+        printf ("telemetry: %8s %6u frames -> %s_%s.csv\n", type_names[type],
+                frames[type], prefix, type_names[type]);
+        fclose (out[type]);
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+genTrace.py
+
+Regenerates the accelerometer traces in this directory. Each trace is raw
+ADXL345 full resolution counts (256 per g) at 100 Hz, in the format read by
+hostTrace.c:
+
+    # rate_hz=100
+    x,y,z,step
+
+The walking style traces are synthesised from a gait model (a heel strike
+impulse plus the body's vertical bounce per step, arm sway on x/y and
+sensor noise) with a fixed seed, so the files are reproducible and their
+step labels are exact. Run from this directory:
+
+    python3 genTrace.py
+
+"python3 genTrace.py --idle-gap NAME" writes only NAME.csv: a walk, five
+minutes lying still and another walk, for the step log's idle test
+("make log-idle"). At 430 s it is too long to keep with the others.
+
+Ben Stewart and Daniel Pallesen
+8th of April 2022
+"""
+
+import math
+import os
+import random
+import sys
+
+RATE_HZ = 100
+G = 256
+
+
+def gait(name, seconds, cadence_hz, bounce_g, strike_g, tilt, noise, seed):
+    rows = gait_rows(seconds, cadence_hz, bounce_g, strike_g, tilt, noise, seed)
+    write(name, rows, "%s: %.2f Hz cadence, tilt %s" % (name, cadence_hz, tilt))
+
+
+def gait_rows(seconds, cadence_hz, bounce_g, strike_g, tilt, noise, seed):
+    rng = random.Random(seed)
+    n = seconds * RATE_HZ
+    pitch, roll = tilt
+    # Gravity direction for a board held at the given tilt (degrees).
+    gx = -math.sin(math.radians(roll)) * math.cos(math.radians(pitch))
+    gy = math.sin(math.radians(pitch))
+    gz = math.cos(math.radians(roll)) * math.cos(math.radians(pitch))
+
+    rows = []
+    phase = 0.99       # first heel strike lands just after walking starts
+    for i in range(n):
+        t = i / RATE_HZ
+        # Start walking after two seconds of standing, stop two before the end.
+        walking = 2.0 <= t < seconds - 2.0
+        step = 0
+        vertical = 0.0
+        if walking:
+            rate = cadence_hz * (1.0 + 0.05 * math.sin(2 * math.pi * t / 7.0))
+            phase += rate / RATE_HZ
+            if phase >= 1.0:
+                # Heel strike: label the step on the sample it lands.
+                phase -= 1.0
+                step = 1
+            vertical = (bounce_g * math.cos(2 * math.pi * phase)
+                        + strike_g * math.exp(-((phase - 0.02) / 0.03) ** 2))
+        sway = 0.08 * math.sin(math.pi * phase) if walking else 0.0
+        x = G * (gx + sway + vertical * gx) + rng.gauss(0, noise)
+        y = G * (gy + 0.5 * sway + vertical * gy) + rng.gauss(0, noise)
+        z = G * (gz + vertical * gz) + rng.gauss(0, noise)
+        rows.append((round(x), round(y), round(z), step))
+    return rows
+
+
+def still(name, seconds, tilt, noise, seed):
+    rows = still_rows(seconds, tilt, noise, seed)
+    write(name, rows, "%s: stationary, tilt %s" % (name, tilt))
+
+
+def still_rows(seconds, tilt, noise, seed):
+    rng = random.Random(seed)
+    pitch, roll = tilt
+    gx = -math.sin(math.radians(roll)) * math.cos(math.radians(pitch))
+    gy = math.sin(math.radians(pitch))
+    gz = math.cos(math.radians(roll)) * math.cos(math.radians(pitch))
+    rows = []
+    for i in range(seconds * RATE_HZ):
+        rows.append((round(G * gx + rng.gauss(0, noise)),
+                     round(G * gy + rng.gauss(0, noise)),
+                     round(G * gz + rng.gauss(0, noise)), 0))
+    return rows
+
+
+def idle_gap(name):
+    # Walk 40 s, put the board down flat for 300 s, then walk 90 s.
+    rows = (gait_rows(40, 1.8, 0.25, 0.6, (10, 5), 3.0, 6)
+            + still_rows(300, (0, 0), 1.5, 7)
+            + gait_rows(90, 1.8, 0.25, 0.6, (10, 5), 3.0, 8))
+    write(name, rows, "%s: walk 40 s, still 300 s, walk 90 s"
+          % os.path.basename(name))
+
+
+def clip(v):
+    # Full resolution at +/-2 g saturates at 10 bits plus sign.
+    return max(-512, min(511, v))
+
+
+def write(name, rows, description):
+    with open(name + ".csv", "w") as f:
+        f.write("# %s\n" % description)
+        f.write("# rate_hz=%d\n" % RATE_HZ)
+        f.write("# steps=%d\n" % sum(r[3] for r in rows))
+        for x, y, z, step in rows:
+            f.write("%d,%d,%d,%d\n" % (clip(x), clip(y), clip(z), step))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) == 3 and sys.argv[1] == "--idle-gap":
+        idle_gap(sys.argv[2])
+        sys.exit(0)
+    gait("walking", 30, 1.8, 0.25, 0.6, (10, 5), 3.0, 1)
+    still("desk", 30, (0, 0), 1.5, 2)
+    # Faster, harder strides that clip at 2 g.
+    gait("running", 30, 2.8, 0.6, 1.5, (20, -10), 5.0, 3)
+    # Slow, heavy steps with the board held steeply.
+    gait("stairs", 30, 1.4, 0.35, 0.9, (35, 0), 4.0, 4)
+    # Near vertical in a trouser pocket: softer strikes, more noise.
+    gait("pocket", 30, 1.9, 0.2, 0.35, (75, 25), 6.0, 5)